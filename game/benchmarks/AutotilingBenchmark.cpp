@@ -0,0 +1,135 @@
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include "PCH.h"
+#include "Level.h"
+
+// The grid sizes to autotile. Each is the number of columns and of rows, rounded up to odd by the level.
+static int const BENCHMARK_GRID_SIZES[] = { 25, 512 };
+
+// The number of tiles autotiled at each size, spread over as many passes as it takes.
+static long long const BENCHMARK_TILES_PER_SIZE = 200000000;
+
+// The number of single tile edits made at each size.
+static int const BENCHMARK_EDIT_COUNT = 100000;
+
+
+// Checks if a tile is a wall the way the per-tile autotiler did, with a bounds check on every call.
+static bool IsWall(const std::vector<TILE>& tiles, sf::Vector2i size, int i, int j)
+{
+    if ((i < 0) || (i >= size.x) || (j < 0) || (j >= size.y))
+    {
+        return false;
+    }
+    return tiles[i * size.y + j] <= TILE::WALL_INTERSECTION;
+}
+
+// Works out the type of every wall by checking the four tiles beside it, as Level::CalculateTextures did before.
+static void CalculateTexturesPerTile(std::vector<TILE>& tiles, sf::Vector2i size)
+{
+    for (int i = 0; i < size.x; ++i)
+    {
+        for (int j = 0; j < size.y; ++j)
+        {
+            if (IsWall(tiles, size, i, j))
+            {
+                int value = 0;
+                if (IsWall(tiles, size, i, j - 1))
+                {
+                    value += 1;
+                }
+                if (IsWall(tiles, size, i + 1, j))
+                {
+                    value += 2;
+                }
+                if (IsWall(tiles, size, i, j + 1))
+                {
+                    value += 4;
+                }
+                if (IsWall(tiles, size, i - 1, j))
+                {
+                    value += 8;
+                }
+                tiles[i * size.y + j] = static_cast<TILE>(value);
+            }
+        }
+    }
+}
+
+// Times the per-tile autotiler against the batched one in Level on generated levels and checks that they agree, then
+// times single tile edits, which only update the tiles around them.
+int main()
+{
+    std::cout << std::left << std::setw(12) << "size" << std::setw(12) << "passes" << std::setw(16) << "per tile (ms)" << std::setw(16) << "batched (ms)"
+        << std::setw(12) << "speedup" << std::setw(12) << "edit (us)" << std::setw(16) << "tiles per edit" << "match" << std::endl;
+
+    for (int gridSize : BENCHMARK_GRID_SIZES)
+    {
+        Level level(sf::Vector2i(gridSize, gridSize));
+        level.SetSeed(1);
+        level.GenerateLevel();
+        sf::Vector2i size = level.GetSize();
+        int passCount = static_cast<int>(BENCHMARK_TILES_PER_SIZE / (size.x * size.y));
+
+        // Start both autotilers from the same layout with every wall the same type.
+        std::vector<TILE> tiles(size.x * size.y);
+        for (int i = 0; i < size.x; ++i)
+        {
+            for (int j = 0; j < size.y; ++j)
+            {
+                TILE type = level.GetTileType(i, j);
+                tiles[i * size.y + j] = (type <= TILE::WALL_INTERSECTION) ? TILE::WALL_TOP : type;
+            }
+        }
+        std::vector<TILE> perTileTiles = tiles;
+        CalculateTexturesPerTile(perTileTiles, size);
+        level.LoadLayout(sf::Vector2i(0, 0), tiles, level.SpawnLocation());
+
+        bool match = true;
+        for (int i = 0; i < size.x; ++i)
+        {
+            for (int j = 0; j < size.y; ++j)
+            {
+                match = match && (level.GetTileType(i, j) == perTileTiles[i * size.y + j]);
+            }
+        }
+
+        auto perTileStart = std::chrono::steady_clock::now();
+        for (int pass = 0; pass < passCount; ++pass)
+        {
+            CalculateTexturesPerTile(perTileTiles, size);
+        }
+        double perTileTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - perTileStart).count() / passCount;
+
+        auto batchedStart = std::chrono::steady_clock::now();
+        for (int pass = 0; pass < passCount; ++pass)
+        {
+            level.CalculateTextures();
+        }
+        double batchedTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - batchedStart).count() / passCount;
+
+        // Knock down and rebuild walls at random. Each edit only updates the tiles around it, so a full pass afterwards should find
+        // nothing left to change.
+        Random random(1, RANDOM_STREAM::LEVEL);
+        std::vector<sf::Vector2i> changedTiles;
+        long long changedCount = 0;
+        auto editStart = std::chrono::steady_clock::now();
+        for (int edit = 0; edit < BENCHMARK_EDIT_COUNT; ++edit)
+        {
+            int column = random.Next(size.x - 2) + 1;
+            int row = random.Next(size.y - 2) + 1;
+            unsigned int revision = level.GetLayoutRevision();
+            level.SetTile(column, row, level.IsFloor(column, row) ? TILE::WALL_TOP : TILE::FLOOR);
+            level.GetChangedTiles(revision, changedTiles);
+            changedCount += changedTiles.size();
+        }
+        double editTime = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - editStart).count() / BENCHMARK_EDIT_COUNT;
+        match = match && (level.CalculateTextures() == 0);
+
+        std::cout << std::left << std::setw(12) << (std::to_string(size.x) + "x" + std::to_string(size.y)) << std::setw(12) << passCount
+            << std::setw(16) << perTileTime << std::setw(16) << batchedTime << std::setw(12) << perTileTime / batchedTime
+            << std::setw(12) << editTime << std::setw(16) << static_cast<double>(changedCount) / BENCHMARK_EDIT_COUNT << (match ? "yes" : "no") << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,50 @@
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include "PCH.h"
+#include "Level.h"
+
+// The grid sizes to generate levels at. Each is the number of columns and of rows.
+static int const BENCHMARK_GRID_SIZES[] = { 25, 51, 101, 201, 401, 801 };
+
+// The number of levels generated at each size, one per seed starting from 0.
+static int const BENCHMARK_LEVELS_PER_SIZE = 20;
+
+
+// Generates levels from fixed seeds at a range of grid sizes and reports how long generation takes.
+int main()
+{
+    std::cout << std::left << std::setw(12) << "size" << std::setw(12) << "tiles" << std::setw(12) << "mean (ms)" << std::setw(12) << "min (ms)"
+        << std::setw(12) << "max (ms)" << "ns per tile" << std::endl;
+
+    for (int gridSize : BENCHMARK_GRID_SIZES)
+    {
+        double totalTime = 0.0;
+        double minTime = 0.0;
+        double maxTime = 0.0;
+        int tileCount = 0;
+
+        for (int seed = 0; seed < BENCHMARK_LEVELS_PER_SIZE; ++seed)
+        {
+            // Generate a level from a fixed seed so runs are comparable.
+            Level level(sf::Vector2i(gridSize, gridSize));
+            level.SetSeed(seed);
+            tileCount = level.GetSize().x * level.GetSize().y;
+
+            auto generateStart = std::chrono::steady_clock::now();
+            level.GenerateLevel();
+            double time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - generateStart).count();
+
+            totalTime += time;
+            minTime = (seed == 0) ? time : std::min(minTime, time);
+            maxTime = std::max(maxTime, time);
+        }
+
+        double meanTime = totalTime / BENCHMARK_LEVELS_PER_SIZE;
+        std::cout << std::setw(12) << (std::to_string(gridSize) + "x" + std::to_string(gridSize)) << std::setw(12) << tileCount << std::setw(12) << meanTime
+            << std::setw(12) << minTime << std::setw(12) << maxTime << meanTime * 1000000.0 / tileCount << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,94 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include "PCH.h"
+#include "LevelStreamer.h"
+#include "PathfindingContext.h"
+
+// The number of chunks the player walks east, far more than the store can hold.
+static int const BENCHMARK_WALK_CHUNK_COUNT = 2000;
+
+// The number of chunks the player walks away before coming back to check that a changed tile was kept.
+static int const BENCHMARK_RETURN_CHUNK_COUNT = 5;
+
+// The number of paths searched from the start to random floor tiles in the other chunks in range.
+static int const BENCHMARK_PATH_COUNT = 200;
+
+
+// Walks a player across an endless floor and reports how long the level takes to move, how much memory the chunks that
+// have gone out of range use, whether changes to a chunk survive leaving it, and whether paths cross chunk edges.
+int main()
+{
+    Level level(LevelStreamer::GetLevelSize());
+    LevelStreamer streamer;
+    PathfindingContext context;
+    std::vector<sf::Vector2f> path;
+    streamer.Reset(1);
+    streamer.Update(level, LevelStreamer::GetStartLocation());
+
+    // Paths from the start to floor tiles anywhere in range, which all have to cross into other chunks.
+    std::srand(1);
+    std::vector<sf::Vector2f> floorLocations = level.GetFloorLocations();
+    const Tile* start = level.GetTile(LevelStreamer::GetStartLocation());
+    int foundCount = 0;
+    for (int i = 0; i < BENCHMARK_PATH_COUNT; ++i)
+    {
+        const Tile* goal = level.GetTile(floorLocations[std::rand() % floorLocations.size()]);
+        foundCount += context.FindPath(level, start, goal, path) ? 1 : 0;
+    }
+
+    // Knock down a wall next to the start, walk away and come back.
+    int wallColumn = start->columnIndex + 1;
+    int wallRow = start->rowIndex;
+    bool hadWall = level.GetTileType(wallColumn, wallRow) != TILE::FLOOR;
+    level.SetTile(wallColumn, wallRow, TILE::FLOOR);
+
+    sf::Vector2f position = LevelStreamer::GetStartLocation();
+    float chunkWidth = static_cast<float>(CHUNK_SIZE * TILE_SIZE);
+    for (int i = 0; i < BENCHMARK_RETURN_CHUNK_COUNT; ++i)
+    {
+        position.x += chunkWidth;
+        streamer.Update(level, position);
+    }
+    for (int i = 0; i < BENCHMARK_RETURN_CHUNK_COUNT; ++i)
+    {
+        position.x -= chunkWidth;
+        streamer.Update(level, position);
+    }
+    const Tile* returnedStart = level.GetTile(LevelStreamer::GetStartLocation());
+    bool keptChange = level.GetTileType(returnedStart->columnIndex + 1, returnedStart->rowIndex) == TILE::FLOOR;
+
+    // Walk east a tile at a time. The level only moves when the player crosses into another chunk.
+    double totalTime = 0.0;
+    double maxTime = 0.0;
+    int moveCount = 0;
+    size_t mostStoredBytes = 0;
+    for (int i = 0; i < BENCHMARK_WALK_CHUNK_COUNT * CHUNK_SIZE; ++i)
+    {
+        position.x += TILE_SIZE;
+        auto updateStart = std::chrono::steady_clock::now();
+        bool moved = streamer.Update(level, position);
+        double updateTime = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - updateStart).count();
+
+        if (moved)
+        {
+            totalTime += updateTime;
+            maxTime = std::max(maxTime, updateTime);
+            moveCount++;
+        }
+        mostStoredBytes = std::max(mostStoredBytes, streamer.GetStoredByteCount());
+    }
+
+    std::cout << "chunk size (tiles):       " << CHUNK_SIZE << std::endl;
+    std::cout << "level size (tiles):       " << level.GetSize().x << std::endl;
+    std::cout << "paths found:              " << foundCount << " / " << BENCHMARK_PATH_COUNT << std::endl;
+    std::cout << "change kept on return:    " << ((hadWall && keptChange) ? "yes" : "no") << std::endl;
+    std::cout << "level moves:              " << moveCount << std::endl;
+    std::cout << "mean move (us):           " << totalTime / moveCount << std::endl;
+    std::cout << "max move (us):            " << maxTime << std::endl;
+    std::cout << "stored chunks:            " << streamer.GetStoredChunkCount() << " (limit " << MAX_STORED_CHUNKS << ")" << std::endl;
+    std::cout << "most stored bytes:        " << mostStoredBytes << std::endl;
+    std::cout << "bytes per stored chunk:   " << static_cast<double>(streamer.GetStoredByteCount()) / streamer.GetStoredChunkCount() << std::endl;
+
+    return 0;
+}
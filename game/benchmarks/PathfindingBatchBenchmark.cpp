@@ -0,0 +1,94 @@
+#include <chrono>
+#include <iostream>
+#include "PCH.h"
+#include "PathfindingBatch.h"
+
+// The number of generated levels to run batches on.
+static int const BENCHMARK_LEVEL_COUNT = 50;
+
+// The number of start/goal requests in each batch.
+static int const BENCHMARK_REQUESTS_PER_BATCH = 2000;
+
+// The largest number of threads to run batches with, if the hardware has fewer.
+static int const BENCHMARK_MIN_MAX_THREAD_COUNT = 4;
+
+
+// Runs the same pathfinding batches with an increasing number of threads, and checks that the paths don't change.
+int main()
+{
+    // Generate the levels and requests up front so every thread count runs exactly the same work.
+    std::vector<std::unique_ptr<Level>> levels;
+    std::vector<std::vector<std::pair<const Tile*, const Tile*>>> requests(BENCHMARK_LEVEL_COUNT);
+
+    for (int seed = 0; seed < BENCHMARK_LEVEL_COUNT; ++seed)
+    {
+        std::srand(static_cast<unsigned int>(seed));
+        levels.push_back(std::unique_ptr<Level>(new Level()));
+        levels.back()->SetSeed(seed);
+        levels.back()->GenerateLevel();
+
+        std::vector<sf::Vector2f> floorLocations = levels.back()->GetFloorLocations();
+        for (int i = 0; i < BENCHMARK_REQUESTS_PER_BATCH; ++i)
+        {
+            const Tile* startNode = levels.back()->GetTile(floorLocations[std::rand() % floorLocations.size()]);
+            const Tile* goalNode = levels.back()->GetTile(floorLocations[std::rand() % floorLocations.size()]);
+            requests[seed].push_back({ startNode, goalNode });
+        }
+    }
+
+    int maxThreadCount = std::max(BENCHMARK_MIN_MAX_THREAD_COUNT, static_cast<int>(std::thread::hardware_concurrency()));
+    double singleThreadSeconds = 0.0;
+    unsigned long long singleThreadChecksum = 0;
+
+    std::cout << "hardware threads:       " << std::thread::hardware_concurrency() << std::endl;
+    std::cout << std::endl;
+
+    for (int threadCount = 1; threadCount <= maxThreadCount; threadCount *= 2)
+    {
+        PathfindingBatch batch(threadCount);
+        std::chrono::steady_clock::duration batchTime(0);
+        unsigned long long checksum = 0;
+        long long expandedNodeCount = 0;
+
+        for (int level = 0; level < BENCHMARK_LEVEL_COUNT; ++level)
+        {
+            batch.Clear();
+            for (const auto& request : requests[level])
+            {
+                batch.Add(request.first, request.second);
+            }
+
+            auto batchStart = std::chrono::steady_clock::now();
+            batch.Run(*levels[level], PATHFINDING_MODE::A_STAR, nullptr, nullptr);
+            batchTime += std::chrono::steady_clock::now() - batchStart;
+
+            // Fold every waypoint into a checksum, in request order.
+            for (int i = 0; i < batch.GetRequestCount(); ++i)
+            {
+                for (const auto& waypoint : batch.GetPath(i))
+                {
+                    checksum = checksum * 1000003 + static_cast<unsigned long long>(waypoint.x * 7 + waypoint.y);
+                }
+                checksum = checksum * 1000003 + 1;
+                expandedNodeCount += batch.GetExpandedNodeCount(i);
+            }
+        }
+
+        double seconds = std::chrono::duration<double>(batchTime).count();
+        if (threadCount == 1)
+        {
+            singleThreadSeconds = seconds;
+            singleThreadChecksum = checksum;
+        }
+
+        std::cout << "threads:                " << threadCount << std::endl;
+        std::cout << "expanded nodes:         " << expandedNodeCount << std::endl;
+        std::cout << "batch time (s):         " << seconds << std::endl;
+        std::cout << "queries per second:     " << (BENCHMARK_LEVEL_COUNT * BENCHMARK_REQUESTS_PER_BATCH) / seconds << std::endl;
+        std::cout << "speedup:                " << singleThreadSeconds / seconds << std::endl;
+        std::cout << "same paths as 1 thread: " << ((checksum == singleThreadChecksum) ? "yes" : "no") << std::endl;
+        std::cout << std::endl;
+    }
+
+    return 0;
+}
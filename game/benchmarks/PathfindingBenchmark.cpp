@@ -0,0 +1,410 @@
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include "PCH.h"
+#include "Enemy.h"
+
+// The number of generated levels to run queries on.
+static int const BENCHMARK_LEVEL_COUNT = 50;
+
+// The number of start/goal queries to run per level.
+static int const BENCHMARK_QUERIES_PER_LEVEL = 2000;
+
+// The number of enemies that share each flow field goal.
+static int const BENCHMARK_ENEMIES_PER_GOAL = 20;
+
+// The number of tiles changed per level to measure hierarchy updates.
+static int const BENCHMARK_TILE_CHANGES_PER_LEVEL = 20;
+
+// The number of tiles the player walks per level while an enemy chases it with an incremental planner.
+static int const BENCHMARK_CHASE_STEPS_PER_LEVEL = 200;
+
+// The number of chase steps between blocking a floor tile and reopening it again.
+static int const BENCHMARK_CHASE_STEPS_PER_TILE_CHANGE = 10;
+
+// The distance within which enemies chase the player, matching the range used by the game.
+static float const BENCHMARK_CHASE_RANGE = 200.f;
+
+
+// The totals gathered for one search mode.
+struct SearchResults
+{
+    long long queryCount = 0;
+    long long expandedNodeCount = 0;
+    long long scannedNodeCount = 0;
+    long long waypointCount = 0;
+    std::chrono::steady_clock::duration searchTime = std::chrono::steady_clock::duration(0);
+};
+
+// The totals gathered for repairs of the incremental planner, and for new searches between the same tiles.
+struct ReplanResults
+{
+    long long repairCount = 0;
+    long long expandedNodeCount = 0;
+    long long touchedNodeCount = 0;
+    std::chrono::steady_clock::duration repairTime = std::chrono::steady_clock::duration(0);
+    long long fullExpandedNodeCount = 0;
+    long long fullTouchedNodeCount = 0;
+    std::chrono::steady_clock::duration fullTime = std::chrono::steady_clock::duration(0);
+    long long aStarExpandedNodeCount = 0;
+};
+
+
+// Prints the totals gathered for repairs of the incremental planner.
+void PrintReplanResults(const std::string& name, const ReplanResults& results)
+{
+    double repairSeconds = std::chrono::duration<double>(results.repairTime).count();
+    double fullSeconds = std::chrono::duration<double>(results.fullTime).count();
+
+    std::cout << name << std::endl;
+    std::cout << "repairs:                " << results.repairCount << std::endl;
+    std::cout << "expanded per repair:    " << static_cast<double>(results.expandedNodeCount) / results.repairCount << std::endl;
+    std::cout << "touched per repair:     " << static_cast<double>(results.touchedNodeCount) / results.repairCount << std::endl;
+    std::cout << "repair time (us):       " << repairSeconds * 1000000.0 / results.repairCount << std::endl;
+    std::cout << "expanded per full:      " << static_cast<double>(results.fullExpandedNodeCount) / results.repairCount << std::endl;
+    std::cout << "touched per full:       " << static_cast<double>(results.fullTouchedNodeCount) / results.repairCount << std::endl;
+    std::cout << "full time (us):         " << fullSeconds * 1000000.0 / results.repairCount << std::endl;
+    std::cout << "A* expanded per query:  " << static_cast<double>(results.aStarExpandedNodeCount) / results.repairCount << std::endl;
+    std::cout << std::endl;
+}
+
+// Runs a list of start/goal queries on a level with the given search mode, through the path cache if one is given.
+void RunQueries(const Level& level, const PathfindingHierarchy& hierarchy, const NextHopTable& nextHopTable, PathCache* cache, const std::vector<std::pair<sf::Vector2f, sf::Vector2f>>& queries, PATHFINDING_MODE mode, SearchResults& results)
+{
+    Random random;
+    Enemy enemy(random);
+    PathfindingContext context;
+
+    for (const auto& query : queries)
+    {
+        enemy.SetPosition(query.first);
+
+        auto searchStart = std::chrono::steady_clock::now();
+        if (cache != nullptr)
+        {
+            enemy.UpdatePathfinding(level, query.second, context, *cache, mode);
+        }
+        else if (mode == PATHFINDING_MODE::HIERARCHICAL)
+        {
+            enemy.UpdatePathfinding(level, query.second, hierarchy, context);
+        }
+        else if (mode == PATHFINDING_MODE::NEXT_HOP_TABLE)
+        {
+            enemy.UpdatePathfinding(level, query.second, nextHopTable);
+        }
+        else
+        {
+            enemy.UpdatePathfinding(level, query.second, context, mode);
+        }
+        results.searchTime += std::chrono::steady_clock::now() - searchStart;
+
+        results.queryCount++;
+        results.expandedNodeCount += enemy.GetExpandedNodeCount();
+        results.scannedNodeCount += context.GetScannedNodeCount();
+        results.waypointCount += static_cast<long long>(enemy.GetTargetPositions().size());
+    }
+}
+
+
+// Prints the totals gathered for one search mode.
+void PrintResults(const std::string& name, const SearchResults& results)
+{
+    double seconds = std::chrono::duration<double>(results.searchTime).count();
+    std::cout << name << std::endl;
+    std::cout << "queries:                " << results.queryCount << std::endl;
+    std::cout << "expanded nodes:         " << results.expandedNodeCount << std::endl;
+    std::cout << "expanded per query:     " << static_cast<double>(results.expandedNodeCount) / results.queryCount << std::endl;
+    std::cout << "scanned nodes:          " << results.scannedNodeCount << std::endl;
+    std::cout << "waypoints:              " << results.waypointCount << std::endl;
+    std::cout << "search time (s):        " << seconds << std::endl;
+    std::cout << "queries per second:     " << results.queryCount / seconds << std::endl;
+    std::cout << "expansions per second:  " << results.expandedNodeCount / seconds << std::endl;
+    std::cout << std::endl;
+}
+
+
+// Runs random start/goal queries with each pathfinding mode and reports the node expansion rates.
+int main()
+{
+    SearchResults aStarResults;
+    SearchResults jumpPointResults;
+    SearchResults hierarchicalResults;
+    SearchResults nextHopResults;
+    SearchResults groupedResults;
+    SearchResults cachedResults;
+
+    PathCache cache;
+
+    PathfindingHierarchy hierarchy;
+    long long hierarchyBuildCount = 0;
+    long long entranceCount = 0;
+    std::chrono::steady_clock::duration hierarchyBuildTime(0);
+    long long hierarchyUpdateCount = 0;
+    long long clustersRebuiltCount = 0;
+    std::chrono::steady_clock::duration hierarchyUpdateTime(0);
+
+    NextHopTable nextHopTable;
+    long long nextHopBuildCount = 0;
+    long long nextHopBuildTime = 0;
+
+    LineOfSight lineOfSight;
+    long long inRangeQueryCount = 0;
+    long long clearQueryCount = 0;
+    std::chrono::steady_clock::duration lineOfSightTime(0);
+
+    FlowField flowField;
+    long long flowFieldBuildCount = 0;
+    long long flowFieldStepCount = 0;
+    std::chrono::steady_clock::duration flowFieldTime(0);
+
+    PathfindingPlanner planner;
+    PathfindingPlanner fullPlanner;
+    PathfindingContext chaseContext;
+    ReplanResults playerStillResults;
+    ReplanResults playerMovedResults;
+
+    for (int seed = 0; seed < BENCHMARK_LEVEL_COUNT; ++seed)
+    {
+        // Generate a level from a fixed seed so runs are comparable.
+        std::srand(static_cast<unsigned int>(seed));
+        Level level;
+        level.SetSeed(seed);
+        level.GenerateLevel();
+
+        // Every mode runs the same queries.
+        std::vector<sf::Vector2f> floorLocations = level.GetFloorLocations();
+        std::vector<std::pair<sf::Vector2f, sf::Vector2f>> queries;
+        for (int i = 0; i < BENCHMARK_QUERIES_PER_LEVEL; ++i)
+        {
+            sf::Vector2f start = floorLocations[std::rand() % floorLocations.size()];
+            sf::Vector2f goal = floorLocations[std::rand() % floorLocations.size()];
+            queries.push_back({ start, goal });
+        }
+
+        auto hierarchyStart = std::chrono::steady_clock::now();
+        hierarchy.Update(level);
+        hierarchyBuildTime += std::chrono::steady_clock::now() - hierarchyStart;
+        hierarchyBuildCount++;
+        entranceCount += hierarchy.GetEntranceCount();
+
+        RunQueries(level, hierarchy, nextHopTable, nullptr, queries, PATHFINDING_MODE::A_STAR, aStarResults);
+        RunQueries(level, hierarchy, nextHopTable, nullptr, queries, PATHFINDING_MODE::JUMP_POINT_SEARCH, jumpPointResults);
+        RunQueries(level, hierarchy, nextHopTable, nullptr, queries, PATHFINDING_MODE::HIERARCHICAL, hierarchicalResults);
+
+        nextHopTable.Build(level);
+        nextHopBuildTime += nextHopTable.GetBuildTime();
+        nextHopBuildCount++;
+        RunQueries(level, hierarchy, nextHopTable, nullptr, queries, PATHFINDING_MODE::NEXT_HOP_TABLE, nextHopResults);
+
+        // Cast a line for each query that an enemy in chase range would make. A clear line replaces the search.
+        lineOfSight.Update(level);
+        for (const auto& query : queries)
+        {
+            sf::Vector2f offset = query.second - query.first;
+            if (std::sqrt(offset.x * offset.x + offset.y * offset.y) >= BENCHMARK_CHASE_RANGE)
+            {
+                continue;
+            }
+
+            auto castStart = std::chrono::steady_clock::now();
+            bool isClear = lineOfSight.IsClear(query.first, query.second, ENTITY_COLLISION_HALF_SIZE);
+            lineOfSightTime += std::chrono::steady_clock::now() - castStart;
+            inRangeQueryCount++;
+            clearQueryCount += isClear ? 1 : 0;
+        }
+
+        // Enemies tend to gather, so group the queries around shared goals with starts on the same or neighbouring tiles.
+        std::vector<std::pair<sf::Vector2f, sf::Vector2f>> groupedQueries;
+        for (int i = 0; i < BENCHMARK_QUERIES_PER_LEVEL; ++i)
+        {
+            const Tile* groupStart = level.GetTile(queries[i - (i % BENCHMARK_ENEMIES_PER_GOAL)].first);
+            sf::Vector2f start = level.GetActualTileLocation(groupStart->columnIndex, groupStart->rowIndex);
+            int column = groupStart->columnIndex + (std::rand() % 3) - 1;
+            int row = groupStart->rowIndex + (std::rand() % 3) - 1;
+            if (level.TileIsValid(column, row) && level.IsFloor(column, row))
+            {
+                start = level.GetActualTileLocation(column, row);
+            }
+            groupedQueries.push_back({ start, queries[i - (i % BENCHMARK_ENEMIES_PER_GOAL)].second });
+        }
+
+        RunQueries(level, hierarchy, nextHopTable, nullptr, groupedQueries, PATHFINDING_MODE::A_STAR, groupedResults);
+
+        // Each level is a new object in the same place with the same revision, so the cache can't tell them apart.
+        cache.Clear();
+        RunQueries(level, hierarchy, nextHopTable, &cache, groupedQueries, PATHFINDING_MODE::A_STAR, cachedResults);
+
+        // Build one flow field per goal, then walk each start that shares the goal down the field.
+        for (int i = 0; i < BENCHMARK_QUERIES_PER_LEVEL; i += BENCHMARK_ENEMIES_PER_GOAL)
+        {
+            auto buildStart = std::chrono::steady_clock::now();
+            flowField.Build(level, level.GetTile(queries[i].second));
+            for (int j = i; j < i + BENCHMARK_ENEMIES_PER_GOAL; ++j)
+            {
+                sf::Vector2f position = queries[j].first;
+                sf::Vector2f waypoint;
+                while (flowField.GetNextWaypoint(level, position, waypoint))
+                {
+                    position = waypoint;
+                    flowFieldStepCount++;
+                }
+            }
+            flowFieldTime += std::chrono::steady_clock::now() - buildStart;
+            flowFieldBuildCount++;
+        }
+
+        // Block and reopen floor tiles, updating the hierarchy after each change.
+        for (int i = 0; i < BENCHMARK_TILE_CHANGES_PER_LEVEL; ++i)
+        {
+            const Tile* tile = level.GetTile(floorLocations[std::rand() % floorLocations.size()]);
+            int column = tile->columnIndex;
+            int row = tile->rowIndex;
+            TILE tileTypes[] = { TILE::WALL_SINGLE, TILE::FLOOR };
+
+            for (TILE tileType : tileTypes)
+            {
+                level.SetTile(column, row, tileType);
+
+                auto updateStart = std::chrono::steady_clock::now();
+                clustersRebuiltCount += hierarchy.Update(level);
+                hierarchyUpdateTime += std::chrono::steady_clock::now() - updateStart;
+                hierarchyUpdateCount++;
+            }
+        }
+
+        // An enemy chases the player, who wanders between random tiles while floor tiles are blocked and reopened.
+        // Each repair of the incremental planner is compared with a new search for the same tiles.
+        const Tile* playerTile = level.GetTile(floorLocations[std::rand() % floorLocations.size()]);
+        const Tile* enemyTile = level.GetTile(floorLocations[std::rand() % floorLocations.size()]);
+        const Tile* blockedTile = nullptr;
+        std::vector<sf::Vector2f> route;
+        std::vector<sf::Vector2f> path;
+
+        for (int step = 0; step < BENCHMARK_CHASE_STEPS_PER_LEVEL; ++step)
+        {
+            // The player stops for one step in three.
+            const Tile* previousPlayerTile = playerTile;
+            if ((step % 3) != 0)
+            {
+                if (route.empty())
+                {
+                    chaseContext.FindPath(level, playerTile, level.GetTile(floorLocations[std::rand() % floorLocations.size()]), route);
+                }
+                if ((!route.empty()) && level.IsFloor(*level.GetTile(route.front())))
+                {
+                    playerTile = level.GetTile(route.front());
+                    route.erase(route.begin());
+                }
+                else
+                {
+                    route.clear();
+                }
+            }
+
+            if ((step % BENCHMARK_CHASE_STEPS_PER_TILE_CHANGE) == 0)
+            {
+                if (blockedTile != nullptr)
+                {
+                    level.SetTile(blockedTile->columnIndex, blockedTile->rowIndex, TILE::FLOOR);
+                    blockedTile = nullptr;
+                }
+                else
+                {
+                    const Tile* tile = level.GetTile(floorLocations[std::rand() % floorLocations.size()]);
+                    if ((tile != playerTile) && (tile != enemyTile))
+                    {
+                        level.SetTile(tile->columnIndex, tile->rowIndex, TILE::WALL_SINGLE);
+                        blockedTile = tile;
+                    }
+                }
+            }
+
+            auto repairStart = std::chrono::steady_clock::now();
+            planner.FindPath(level, enemyTile, playerTile, path);
+            auto repairEnd = std::chrono::steady_clock::now();
+            if (planner.IsRepair())
+            {
+                ReplanResults& results = (playerTile != previousPlayerTile) ? playerMovedResults : playerStillResults;
+                results.repairTime += repairEnd - repairStart;
+                results.repairCount++;
+                results.expandedNodeCount += planner.GetExpandedNodeCount();
+                results.touchedNodeCount += planner.GetTouchedNodeCount();
+
+                std::vector<sf::Vector2f> fullPath;
+                auto fullStart = std::chrono::steady_clock::now();
+                fullPlanner.Reset();
+                fullPlanner.FindPath(level, enemyTile, playerTile, fullPath);
+                results.fullTime += std::chrono::steady_clock::now() - fullStart;
+                results.fullExpandedNodeCount += fullPlanner.GetExpandedNodeCount();
+                results.fullTouchedNodeCount += fullPlanner.GetTouchedNodeCount();
+
+                chaseContext.FindPath(level, enemyTile, playerTile, fullPath);
+                results.aStarExpandedNodeCount += chaseContext.GetExpandedNodeCount();
+            }
+
+            // The enemy is a little slower than the player, and steps along its path every other step.
+            if (((step % 2) == 0) && (path.size() > 1))
+            {
+                enemyTile = level.GetTile(path.front());
+            }
+        }
+
+        if (blockedTile != nullptr)
+        {
+            level.SetTile(blockedTile->columnIndex, blockedTile->rowIndex, TILE::FLOOR);
+        }
+    }
+
+    PrintResults("A*", aStarResults);
+    PrintResults("jump point search", jumpPointResults);
+    PrintResults("hierarchical", hierarchicalResults);
+    PrintResults("next hop table", nextHopResults);
+    PrintResults("A* grouped", groupedResults);
+    PrintResults("A* grouped with path cache", cachedResults);
+
+    std::cout << "path cache" << std::endl;
+    std::cout << "capacity:               " << PATH_CACHE_CAPACITY << std::endl;
+    std::cout << "hits:                   " << cache.GetHitCount() << std::endl;
+    std::cout << "misses:                 " << cache.GetMissCount() << std::endl;
+    std::cout << "hit rate:               " << static_cast<double>(cache.GetHitCount()) / (cache.GetHitCount() + cache.GetMissCount()) << std::endl;
+    std::cout << std::endl;
+
+    std::cout << "next hop table" << std::endl;
+    std::cout << "memory (bytes):         " << nextHopTable.GetMemoryUsage() << std::endl;
+    std::cout << "max tiles:              " << NEXT_HOP_TABLE_MAX_NODE_COUNT << std::endl;
+    std::cout << "build time (us):        " << static_cast<double>(nextHopBuildTime) / nextHopBuildCount << std::endl;
+    std::cout << std::endl;
+
+    std::cout << "line of sight" << std::endl;
+    std::cout << "queries in chase range: " << inRangeQueryCount << std::endl;
+    std::cout << "searches avoided:       " << clearQueryCount << std::endl;
+    std::cout << "avoided rate:           " << static_cast<double>(clearQueryCount) / inRangeQueryCount << std::endl;
+    std::cout << "time per line (us):     " << std::chrono::duration<double, std::micro>(lineOfSightTime).count() / inRangeQueryCount << std::endl;
+    std::cout << std::endl;
+
+    double hierarchyBuildSeconds = std::chrono::duration<double>(hierarchyBuildTime).count();
+    double hierarchyUpdateSeconds = std::chrono::duration<double>(hierarchyUpdateTime).count();
+    std::cout << "hierarchy" << std::endl;
+    std::cout << "builds:                 " << hierarchyBuildCount << std::endl;
+    std::cout << "entrances per level:    " << static_cast<double>(entranceCount) / hierarchyBuildCount << std::endl;
+    std::cout << "build time (us):        " << hierarchyBuildSeconds * 1000000.0 / hierarchyBuildCount << std::endl;
+    std::cout << "tile updates:           " << hierarchyUpdateCount << std::endl;
+    std::cout << "clusters per update:    " << static_cast<double>(clustersRebuiltCount) / hierarchyUpdateCount << std::endl;
+    std::cout << "update time (us):       " << hierarchyUpdateSeconds * 1000000.0 / hierarchyUpdateCount << std::endl;
+    std::cout << std::endl;
+
+    double flowFieldSeconds = std::chrono::duration<double>(flowFieldTime).count();
+    std::cout << "flow field" << std::endl;
+    std::cout << "builds:                 " << flowFieldBuildCount << std::endl;
+    std::cout << "steps:                  " << flowFieldStepCount << std::endl;
+    std::cout << "time (s):               " << flowFieldSeconds << std::endl;
+    std::cout << "enemy paths per second: " << (flowFieldBuildCount * BENCHMARK_ENEMIES_PER_GOAL) / flowFieldSeconds << std::endl;
+    std::cout << std::endl;
+
+    std::cout << std::endl;
+
+    PrintReplanResults("incremental, player still", playerStillResults);
+    PrintReplanResults("incremental, player moved", playerMovedResults);
+
+    return 0;
+}
@@ -0,0 +1,186 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include "PCH.h"
+#include "PathfindingScheduler.h"
+
+// The number of generated levels to walk the player through.
+static int const BENCHMARK_LEVEL_COUNT = 50;
+
+// The number of enemies chasing the player in each level.
+static int const BENCHMARK_ENEMY_COUNT = 30;
+
+// The number of tiles the player walks in each level. Every enemy repaths each time the player changes tile.
+static int const BENCHMARK_PLAYER_STEP_COUNT = 40;
+
+// The number of frames the player takes to cross a tile.
+static int const BENCHMARK_FRAMES_PER_STEP = 8;
+
+// The time in microseconds the scheduler can use each frame.
+static int const BENCHMARK_BUDGET = 200;
+
+
+// Gets the value below which the given fraction of frame times fall.
+static double Percentile(std::vector<double> frameTimes, double fraction)
+{
+    std::sort(frameTimes.begin(), frameTimes.end());
+    return frameTimes[static_cast<size_t>(fraction * (frameTimes.size() - 1))];
+}
+
+// Prints the frame time spread of one way of running the searches. A slice can finish just after the deadline, so only
+// frames well over the budget are counted as over it.
+static void PrintFrameTimes(const char* name, const std::vector<double>& frameTimes)
+{
+    double total = 0.0;
+    int overBudgetCount = 0;
+    for (double frameTime : frameTimes)
+    {
+        total += frameTime;
+        overBudgetCount += (frameTime > BENCHMARK_BUDGET * 1.1) ? 1 : 0;
+    }
+
+    std::cout << name << std::endl;
+    std::cout << "  frames:                " << frameTimes.size() << std::endl;
+    std::cout << "  mean frame (us):       " << total / frameTimes.size() << std::endl;
+    std::cout << "  p50 frame (us):        " << Percentile(frameTimes, 0.5) << std::endl;
+    std::cout << "  p99 frame (us):        " << Percentile(frameTimes, 0.99) << std::endl;
+    std::cout << "  max frame (us):        " << Percentile(frameTimes, 1.0) << std::endl;
+    std::cout << "  frames >10% over budget: " << overBudgetCount << std::endl;
+}
+
+// Walks a player through generated levels with enemies repathing towards it, and compares the pathfinding time of each
+// frame when all searches run as soon as the player moves against when the scheduler spreads them over frames, on one thread and on the worker threads.
+int main()
+{
+    std::vector<double> immediateFrameTimes;
+    std::vector<double> scheduledFrameTimes;
+    std::vector<double> pooledFrameTimes;
+    long long immediateExpandedNodeCount = 0;
+    long long scheduledExpandedNodeCount = 0;
+    long long pendingAtStepCount = 0;
+    int stepCount = 0;
+    int mostPending = 0;
+
+    PathfindingContext context;
+    PathfindingScheduler scheduler;
+    PathfindingBatch batch;
+    std::vector<sf::Vector2f> playerPath;
+
+    for (int seed = 0; seed < BENCHMARK_LEVEL_COUNT; ++seed)
+    {
+        std::srand(static_cast<unsigned int>(seed));
+        Level level;
+        level.SetSeed(seed);
+        level.GenerateLevel();
+
+        // The player walks the path between two random floor tiles.
+        std::vector<sf::Vector2f> floorLocations = level.GetFloorLocations();
+        const Tile* playerStart = level.GetTile(floorLocations[std::rand() % floorLocations.size()]);
+        const Tile* playerEnd = level.GetTile(floorLocations[std::rand() % floorLocations.size()]);
+        context.FindPath(level, playerStart, playerEnd, playerPath);
+        playerPath.insert(playerPath.begin(), level.GetActualTileLocation(playerStart->columnIndex, playerStart->rowIndex));
+        if (playerPath.size() > static_cast<size_t>(BENCHMARK_PLAYER_STEP_COUNT))
+        {
+            playerPath.resize(BENCHMARK_PLAYER_STEP_COUNT);
+        }
+
+        std::vector<sf::Vector2f> enemyPositions;
+        for (int i = 0; i < BENCHMARK_ENEMY_COUNT; ++i)
+        {
+            enemyPositions.push_back(floorLocations[std::rand() % floorLocations.size()]);
+        }
+
+        // All searches at once, the way the game ran them before. Only the frame the player changes tile does any work.
+        Random random;
+        std::vector<Enemy> enemies(BENCHMARK_ENEMY_COUNT, Enemy(random));
+        for (const auto& playerPosition : playerPath)
+        {
+            auto frameStart = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < enemies.size(); ++i)
+            {
+                enemies[i].SetPosition(enemyPositions[i]);
+                enemies[i].UpdatePathfinding(level, playerPosition, context);
+                immediateExpandedNodeCount += enemies[i].GetExpandedNodeCount();
+            }
+            immediateFrameTimes.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - frameStart).count());
+
+            for (int frame = 1; frame < BENCHMARK_FRAMES_PER_STEP; ++frame)
+            {
+                immediateFrameTimes.push_back(0.0);
+            }
+        }
+
+        // The same searches spread over frames by the scheduler, closest enemies first.
+        scheduler.Clear();
+        for (size_t i = 0; i < enemies.size(); ++i)
+        {
+            enemies[i].SetPosition(enemyPositions[i]);
+        }
+
+        for (const auto& playerPosition : playerPath)
+        {
+            stepCount++;
+            pendingAtStepCount += scheduler.GetPendingCount();
+            mostPending = std::max(mostPending, scheduler.GetPendingCount());
+
+            const Tile* playerTile = level.GetTile(playerPosition);
+            for (auto& enemy : enemies)
+            {
+                sf::Vector2f offset = enemy.GetPosition() - playerPosition;
+                scheduler.Request(&enemy, level.GetTile(enemy.GetPosition()), playerTile, std::sqrt(offset.x * offset.x + offset.y * offset.y));
+            }
+
+            for (int frame = 0; frame < BENCHMARK_FRAMES_PER_STEP; ++frame)
+            {
+                auto frameStart = std::chrono::steady_clock::now();
+                scheduler.Update(level, PATHFINDING_MODE::A_STAR, nullptr, nullptr, BENCHMARK_BUDGET);
+                scheduledFrameTimes.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - frameStart).count());
+                scheduledExpandedNodeCount += scheduler.GetExpandedNodeCount();
+            }
+        }
+
+        // The same again, with the scheduler running each frame's searches across the worker threads, the way the game does.
+        scheduler.Clear();
+        for (size_t i = 0; i < enemies.size(); ++i)
+        {
+            enemies[i].SetPosition(enemyPositions[i]);
+        }
+
+        for (const auto& playerPosition : playerPath)
+        {
+            const Tile* playerTile = level.GetTile(playerPosition);
+            for (auto& enemy : enemies)
+            {
+                sf::Vector2f offset = enemy.GetPosition() - playerPosition;
+                scheduler.Request(&enemy, level.GetTile(enemy.GetPosition()), playerTile, std::sqrt(offset.x * offset.x + offset.y * offset.y));
+            }
+
+            for (int frame = 0; frame < BENCHMARK_FRAMES_PER_STEP; ++frame)
+            {
+                auto frameStart = std::chrono::steady_clock::now();
+                scheduler.Update(level, PATHFINDING_MODE::A_STAR, nullptr, nullptr, BENCHMARK_BUDGET, &batch);
+                pooledFrameTimes.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - frameStart).count());
+            }
+        }
+    }
+
+    std::cout << "budget per frame (us):   " << BENCHMARK_BUDGET << std::endl;
+    std::cout << "slice size (nodes):      " << PATHFINDING_SLICE_SIZE << std::endl;
+    std::cout << std::endl;
+
+    PrintFrameTimes("all searches at once", immediateFrameTimes);
+    std::cout << "  expanded nodes:        " << immediateExpandedNodeCount << std::endl;
+    std::cout << std::endl;
+
+    PrintFrameTimes("scheduled", scheduledFrameTimes);
+    std::cout << "  expanded nodes:        " << scheduledExpandedNodeCount << std::endl;
+    std::cout << "  mean pending per step: " << static_cast<double>(pendingAtStepCount) / stepCount << std::endl;
+    std::cout << "  most pending:          " << mostPending << std::endl;
+    std::cout << std::endl;
+
+    PrintFrameTimes("scheduled on the worker threads", pooledFrameTimes);
+    std::cout << "  threads:               " << batch.GetThreadCount() << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,325 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include "PCH.h"
+#include "Enemy.h"
+
+// The number of generated levels to run queries on, one per seed starting from 0.
+static int const BENCHMARK_DEFAULT_SEED_COUNT = 50;
+
+// The number of start/goal queries to run per level.
+static int const BENCHMARK_DEFAULT_QUERIES_PER_LEVEL = 2000;
+
+// The hand made level that ships with the game, relative to the bin directory the game runs from.
+static char const* const BENCHMARK_DEFAULT_LEVEL_FILE = "../resources/data/level_data.lvl";
+
+// The number of heap allocations made since the program started.
+static std::atomic<long long> allocationCount(0);
+
+
+// Counts every heap allocation made by the program, so the allocations made by each query can be measured.
+void* operator new(std::size_t size)
+{
+    allocationCount++;
+    void* memory = std::malloc(size == 0 ? 1 : size);
+    if (memory == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+// Counts every array allocation in the same way.
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+// Frees memory allocated by the counting operator new.
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+// Frees memory allocated by the counting operator new, when the compiler passes the size.
+void operator delete(void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+// Frees memory allocated by the counting operator new[].
+void operator delete[](void* memory) noexcept
+{
+    std::free(memory);
+}
+
+// Frees memory allocated by the counting operator new[], when the compiler passes the size.
+void operator delete[](void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+
+// The measurements of every query run with one search mode on one set of levels.
+struct SuiteResults
+{
+    std::string layouts;
+    std::string mode;
+    int levelCount = 0;
+    std::vector<double> latencies;
+    long long expandedNodeCount = 0;
+    long long allocationCount = 0;
+};
+
+
+// Gets the name of a search mode as it appears in the output.
+static const char* GetModeName(PATHFINDING_MODE mode)
+{
+    switch (mode)
+    {
+    case PATHFINDING_MODE::JUMP_POINT_SEARCH:
+        return "jump_point_search";
+    case PATHFINDING_MODE::HIERARCHICAL:
+        return "hierarchical";
+    case PATHFINDING_MODE::NEXT_HOP_TABLE:
+        return "next_hop_table";
+    default:
+        return "a_star";
+    }
+}
+
+// Runs a list of start/goal queries through Enemy::UpdatePathfinding, measuring each one on its own.
+static void RunQueries(const Level& level, const std::vector<std::pair<sf::Vector2f, sf::Vector2f>>& queries, PATHFINDING_MODE mode, SuiteResults& results)
+{
+    Random random;
+    Enemy enemy(random);
+    PathfindingContext context;
+    PathfindingHierarchy hierarchy;
+    hierarchy.Update(level);
+    NextHopTable nextHopTable;
+    if (mode == PATHFINDING_MODE::NEXT_HOP_TABLE)
+    {
+        // The table isn't built for large levels, so there is nothing to measure.
+        nextHopTable.Build(level);
+        if (!nextHopTable.IsReady(level))
+        {
+            return;
+        }
+    }
+
+    for (const auto& query : queries)
+    {
+        enemy.SetPosition(query.first);
+
+        long long allocationsBefore = allocationCount;
+        auto searchStart = std::chrono::steady_clock::now();
+        if (mode == PATHFINDING_MODE::HIERARCHICAL)
+        {
+            enemy.UpdatePathfinding(level, query.second, hierarchy, context);
+        }
+        else if (mode == PATHFINDING_MODE::NEXT_HOP_TABLE)
+        {
+            enemy.UpdatePathfinding(level, query.second, nextHopTable);
+        }
+        else
+        {
+            enemy.UpdatePathfinding(level, query.second, context, mode);
+        }
+        auto searchEnd = std::chrono::steady_clock::now();
+        long long allocationsAfter = allocationCount;
+
+        results.latencies.push_back(std::chrono::duration<double, std::micro>(searchEnd - searchStart).count());
+        results.expandedNodeCount += enemy.GetExpandedNodeCount();
+        results.allocationCount += allocationsAfter - allocationsBefore;
+    }
+}
+
+// Makes random start/goal queries between the floor tiles of a level.
+static std::vector<std::pair<sf::Vector2f, sf::Vector2f>> MakeQueries(Level& level, int queryCount)
+{
+    std::vector<sf::Vector2f> floorLocations = level.GetFloorLocations();
+    std::vector<std::pair<sf::Vector2f, sf::Vector2f>> queries;
+    for (int i = 0; i < queryCount; ++i)
+    {
+        sf::Vector2f start = floorLocations[std::rand() % floorLocations.size()];
+        sf::Vector2f goal = floorLocations[std::rand() % floorLocations.size()];
+        queries.push_back({ start, goal });
+    }
+    return queries;
+}
+
+// Gets the value below which the given fraction of the sorted values fall.
+static double Percentile(const std::vector<double>& sortedValues, double fraction)
+{
+    if (sortedValues.empty())
+    {
+        return 0.0;
+    }
+    return sortedValues[static_cast<size_t>(fraction * (sortedValues.size() - 1))];
+}
+
+// Quotes a string for JSON.
+static std::string Quote(const std::string& value)
+{
+    std::string quoted = "\"";
+    for (char character : value)
+    {
+        if ((character == '"') || (character == '\\'))
+        {
+            quoted += '\\';
+        }
+        quoted += character;
+    }
+    return quoted + "\"";
+}
+
+// Writes the results as JSON.
+static void WriteJson(std::ostream& output, int seedCount, sf::Vector2i levelSize, int queriesPerLevel, const std::string& levelFile, bool levelFileLoaded, std::vector<SuiteResults>& allResults)
+{
+    output << "{" << std::endl;
+    output << "  \"seeds\": " << seedCount << "," << std::endl;
+    output << "  \"level_size\": [" << levelSize.x << ", " << levelSize.y << "]," << std::endl;
+    output << "  \"queries_per_level\": " << queriesPerLevel << "," << std::endl;
+    output << "  \"level_file\": " << Quote(levelFile) << "," << std::endl;
+    output << "  \"level_file_loaded\": " << (levelFileLoaded ? "true" : "false") << "," << std::endl;
+    output << "  \"results\": [" << std::endl;
+
+    for (size_t i = 0; i < allResults.size(); ++i)
+    {
+        SuiteResults& results = allResults[i];
+        std::sort(results.latencies.begin(), results.latencies.end());
+
+        double totalLatency = 0.0;
+        for (double latency : results.latencies)
+        {
+            totalLatency += latency;
+        }
+        double queryCount = static_cast<double>(std::max<size_t>(results.latencies.size(), 1));
+
+        output << "    {" << std::endl;
+        output << "      \"layouts\": " << Quote(results.layouts) << "," << std::endl;
+        output << "      \"mode\": " << Quote(results.mode) << "," << std::endl;
+        output << "      \"levels\": " << results.levelCount << "," << std::endl;
+        output << "      \"queries\": " << results.latencies.size() << "," << std::endl;
+        output << "      \"latency_us\": { \"p50\": " << Percentile(results.latencies, 0.5) << ", \"p99\": " << Percentile(results.latencies, 0.99)
+            << ", \"mean\": " << totalLatency / queryCount << ", \"max\": " << Percentile(results.latencies, 1.0) << " }," << std::endl;
+        output << "      \"expanded_nodes_per_query\": " << results.expandedNodeCount / queryCount << "," << std::endl;
+        output << "      \"allocations_per_query\": " << results.allocationCount / queryCount << std::endl;
+        output << "    }" << ((i + 1 < allResults.size()) ? "," : "") << std::endl;
+    }
+
+    output << "  ]" << std::endl;
+    output << "}" << std::endl;
+}
+
+
+// Measures Enemy::UpdatePathfinding on generated levels from fixed seeds and on the level file, and writes the results as JSON.
+// Usage: pathfinding_suite_benchmark [--seeds N] [--size N] [--queries N] [--level-file PATH] [--output PATH]
+int main(int argc, char* argv[])
+{
+    int seedCount = BENCHMARK_DEFAULT_SEED_COUNT;
+    sf::Vector2i levelSize(GRID_WIDTH, GRID_HEIGHT);
+    int queriesPerLevel = BENCHMARK_DEFAULT_QUERIES_PER_LEVEL;
+    std::string levelFile = BENCHMARK_DEFAULT_LEVEL_FILE;
+    std::string outputFile;
+
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        std::string option = argv[i];
+        if (option == "--seeds")
+        {
+            seedCount = std::max(0, std::atoi(argv[i + 1]));
+        }
+        else if (option == "--size")
+        {
+            levelSize.x = levelSize.y = std::atoi(argv[i + 1]);
+        }
+        else if (option == "--queries")
+        {
+            queriesPerLevel = std::max(1, std::atoi(argv[i + 1]));
+        }
+        else if (option == "--level-file")
+        {
+            levelFile = argv[i + 1];
+        }
+        else if (option == "--output")
+        {
+            outputFile = argv[i + 1];
+        }
+        else
+        {
+            std::cerr << "unknown option: " << option << std::endl;
+            return 1;
+        }
+    }
+
+    PATHFINDING_MODE modes[] = { PATHFINDING_MODE::A_STAR, PATHFINDING_MODE::JUMP_POINT_SEARCH, PATHFINDING_MODE::HIERARCHICAL, PATHFINDING_MODE::NEXT_HOP_TABLE };
+    std::vector<SuiteResults> allResults;
+
+    for (PATHFINDING_MODE mode : modes)
+    {
+        SuiteResults results;
+        results.layouts = "generated";
+        results.mode = GetModeName(mode);
+
+        for (int seed = 0; seed < seedCount; ++seed)
+        {
+            // Generate a level from a fixed seed so runs are comparable.
+            std::srand(static_cast<unsigned int>(seed));
+            Level level(levelSize);
+            level.SetSeed(seed);
+            level.GenerateLevel();
+
+            RunQueries(level, MakeQueries(level, queriesPerLevel), mode, results);
+            results.levelCount++;
+        }
+
+        allResults.push_back(std::move(results));
+    }
+
+    // Sizes are rounded to ones the level can be generated in, so report the size that was used.
+    levelSize = Level(levelSize).GetSize();
+
+    Level fileLevel;
+    bool levelFileLoaded = fileLevel.LoadLevelFromFile(levelFile) && (!fileLevel.GetFloorLocations().empty());
+    if (!levelFileLoaded)
+    {
+        std::cerr << "could not load " << levelFile << ", skipping it" << std::endl;
+    }
+    else
+    {
+        for (PATHFINDING_MODE mode : modes)
+        {
+            SuiteResults results;
+            results.layouts = "level_file";
+            results.mode = GetModeName(mode);
+            results.levelCount = 1;
+
+            // The same queries for every mode.
+            std::srand(0);
+            RunQueries(fileLevel, MakeQueries(fileLevel, queriesPerLevel), mode, results);
+            allResults.push_back(std::move(results));
+        }
+    }
+
+    if (outputFile.empty())
+    {
+        WriteJson(std::cout, seedCount, levelSize, queriesPerLevel, levelFile, levelFileLoaded, allResults);
+    }
+    else
+    {
+        std::ofstream output(outputFile);
+        if (!output.is_open())
+        {
+            std::cerr << "could not write " << outputFile << std::endl;
+            return 1;
+        }
+        WriteJson(output, seedCount, levelSize, queriesPerLevel, levelFile, levelFileLoaded, allResults);
+    }
+
+    return 0;
+}
@@ -13,21 +13,27 @@
 
 #include "Entity.h"
 #include "Level.h"
+#include "PathfindingContext.h"
+#include "FlowField.h"
+#include "PathCache.h"
+#include "PathfindingPlanner.h"
+#include "NextHopTable.h"
+#include "LineOfSight.h"
 
 static const int ENEMY_MAX_DAMAGE = 25;
 static const float ENEMY_DEXTERITY_DAMAGE_SCALE = 0.025f;
 static const float ENEMY_ATTACK_DAMAGE_SCALE = 0.15f;
 static const float ENEMY_TAKEN_DAMAGE_REDUCTION_SCALE = 0.15f;
-static const int ENEMY_PATHFINDING_STEP_COST = 10;
 
 
 class Enemy : public Entity
 {
 public:
 	/**
-	 * Default constructor.
+	 * Constructor.
+	 * @param random The random number stream to choose the enemy's stats with.
 	 */
-	Enemy();
+	explicit Enemy(Random& random);
 
     /**
      * Overrides the default Update function in Enemy
@@ -48,14 +54,94 @@ public:
 
 	/**
      * Calculate an amount of damage to an enemy.
+     * @param random The random number stream to roll the damage with.
      * @return Dealt damage to an enemy.
      */
-	int CalculateDamage();
+	int CalculateDamage(Random& random);
 
     /**
      * Recalculates the target position of the enemy.
+     * @param level The level to find a path through. It is not modified by the search.
+     * @param playerPosition The position of the player, which is the goal of the path.
+     * @param context The search context that holds the scratch data for the search.
+     * @param mode The search to use, either A_STAR or JUMP_POINT_SEARCH.
      */
-    void UpdatePathfinding(Level& level, sf::Vector2f playerPosition);
+    void UpdatePathfinding(const Level& level, sf::Vector2f playerPosition, PathfindingContext& context, PATHFINDING_MODE mode = PATHFINDING_MODE::A_STAR);
+
+    /**
+     * Recalculates the target position of the enemy, reusing the path stored for the same start and goal tiles if there is one.
+     * @param level The level to find a path through. It is not modified by the search.
+     * @param playerPosition The position of the player, which is the goal of the path.
+     * @param context The search context that holds the scratch data for the search.
+     * @param cache The paths found by earlier searches. New paths are added to it. It should only be used with one search mode.
+     * @param mode The search to use, either A_STAR or JUMP_POINT_SEARCH.
+     */
+    void UpdatePathfinding(const Level& level, sf::Vector2f playerPosition, PathfindingContext& context, PathCache& cache, PATHFINDING_MODE mode = PATHFINDING_MODE::A_STAR);
+
+    /**
+     * Recalculates the target position of the enemy through the abstract graph of a pathfinding hierarchy.
+     * @param level The level to find a path through. It is not modified by the search.
+     * @param playerPosition The position of the player, which is the goal of the path.
+     * @param hierarchy The abstract graph of the level. It must be up to date with the level.
+     * @param context The search context that holds the scratch data for the search.
+     */
+    void UpdatePathfinding(const Level& level, sf::Vector2f playerPosition, const PathfindingHierarchy& hierarchy, PathfindingContext& context);
+
+    /**
+     * Recalculates the target position of the enemy with its own incremental planner.
+     * The planner repairs the previous search when the player has moved one tile or tiles have changed, instead of starting again.
+     * @param level The level to find a path through. It is not modified by the search.
+     * @param playerPosition The position of the player, which is the goal of the path.
+     */
+    void UpdatePathfinding(const Level& level, sf::Vector2f playerPosition);
+
+    /**
+     * Recalculates the target position of the enemy by reading the path from a table of precomputed first steps.
+     * @param level The level to find a path through.
+     * @param playerPosition The position of the player, which is the goal of the path.
+     * @param nextHopTable The table of first steps between every pair of tiles. It must be ready for the level.
+     */
+    void UpdatePathfinding(const Level& level, sf::Vector2f playerPosition, const NextHopTable& nextHopTable);
+
+    /**
+     * Sets the player as the only target position of the enemy if the enemy can move straight to it without hitting a solid tile.
+     * @param lineOfSight The solid tiles of the level. It must be up to date with the level.
+     * @param playerPosition The position of the player, which is the goal of the path.
+     * @return True if the way was clear. If not, the target positions are left unchanged and a search is needed.
+     */
+    bool UpdateDirectPath(const LineOfSight& lineOfSight, sf::Vector2f playerPosition);
+
+    /**
+     * Sets the path of the enemy to one found by a search that ran elsewhere, such as in a pathfinding batch.
+     * @param path The positions of the tiles on the path, excluding the start tile.
+     * @param expandedNodeCount The number of nodes that the search expanded.
+     */
+    void SetPath(const std::vector<sf::Vector2f>& path, int expandedNodeCount);
+
+    /**
+     * Makes the enemy follow a flow field towards its goal.
+     * The enemy takes its next waypoint from the field each time it reaches the current one.
+     * @param level The level that the field was built for.
+     * @param flowField The flow field to follow. It must outlive the enemy, or be cleared first.
+     */
+    void UpdatePathfinding(const Level& level, const FlowField& flowField);
+
+    /**
+     * Stops the enemy following a flow field once it reaches its current waypoint.
+     */
+    void ClearFlowField();
+
+    /**
+     * Gets the target positions of the enemy.
+     * @return The waypoints that the enemy is following, ordered from first to last.
+     */
+    const std::vector<sf::Vector2f>& GetTargetPositions() const;
+
+    /**
+     * Gets the number of nodes that the last pathfinding search expanded.
+     * @return The number of nodes moved to the closed list by the last search.
+     */
+    int GetExpandedNodeCount() const;
 private:
     /**
      * The target positions of the enemy.
@@ -67,5 +153,20 @@ private:
      */
     sf::Vector2f m_currentTarget;
 
+    /**
+     * The number of nodes that the last pathfinding search expanded.
+     */
+    int m_expandedNodeCount;
+
+    /**
+     * The flow field that the enemy is following, if any.
+     */
+    const FlowField* m_flowField;
+
+    /**
+     * The incremental search towards the player, kept between updates so it can be repaired.
+     */
+    PathfindingPlanner m_planner;
+
 };
 #endif
@@ -14,6 +14,9 @@
 #include "Object.h"
 #include "Level.h"
 
+// Half the width of the square that entities collide with the level by.
+static float const ENTITY_COLLISION_HALF_SIZE = 14.f;
+
 class Entity : public Object
 {
 public:
@@ -0,0 +1,65 @@
+//-------------------------------------------------------------------------------------
+// FlowField.h
+//
+// THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A
+// PARTICULAR PURPOSE.
+//
+// Written by Dale Green. Copyright (c) Packt Publishing. All rights reserved.
+//-------------------------------------------------------------------------------------
+#ifndef FLOWFIELD_H
+#define FLOWFIELD_H
+
+#include "Level.h"
+
+class FlowField
+{
+public:
+	/**
+	 * Default constructor.
+	 */
+	FlowField();
+
+	/**
+	 * Calculates the step distance from every floor tile in the level to the goal tile.
+	 * Movement is 8-connected with a uniform cost, the same as the A* search.
+	 * @param level The level to build the field for.
+	 * @param goalNode The tile that all enemies move towards.
+	 */
+	void Build(const Level& level, const Tile* goalNode);
+
+	/**
+	 * Gets the number of steps from a tile to the goal.
+	 * @param columnIndex The column that the tile is in.
+	 * @param rowIndex The row that the tile is in.
+	 * @return The number of steps to the goal, or -1 if the goal can't be reached from the tile.
+	 */
+	int GetDistance(int columnIndex, int rowIndex) const;
+
+	/**
+	 * Gets the next waypoint towards the goal by descending the distance field.
+	 * @param level The level that the field was built for.
+	 * @param position The current position.
+	 * @param waypoint Receives the location of the next tile to move to.
+	 * @return True if there is a next waypoint. False at the goal, or if the goal can't be reached.
+	 */
+	bool GetNextWaypoint(const Level& level, sf::Vector2f position, sf::Vector2f& waypoint) const;
+
+private:
+	/**
+	 * The number of steps from each tile to the goal, indexed by column * height + row.
+	 */
+	std::vector<int> m_distances;
+
+	/**
+	 * The queue of tiles used while building the field.
+	 */
+	std::vector<int> m_openList;
+
+	/**
+	 * The size of the level that the field was built for.
+	 */
+	sf::Vector2i m_size;
+};
+#endif
\ No newline at end of file
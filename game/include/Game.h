@@ -21,14 +21,29 @@
 #include "Heart.h"
 #include "Slime.h"
 #include "Humanoid.h"
+#include "PathfindingBatch.h"
+#include "PathfindingScheduler.h"
+#include "LevelGenerator.h"
+#include "LevelStreamer.h"
 
 static float const FPS = 60.0;						// Constant for fixed time - step loop. We'll lock it at 60fps.
 static float const MS_PER_STEP = 1.0f / FPS;		// Roughly (0.017) @ 60fps.
 
-static int const MAX_ITEM_SPAWN_COUNT = 50;
-static int const MAX_ENEMY_SPAWN_COUNT = 30;
 static int const MAX_FLOOR_ALT_COUNT = 80;
 
+// How enemies within range of the player find their way to the player, when they can't move straight to it.
+// Only searches go through the path cache, so it is used by A_STAR, JUMP_POINT_SEARCH and HIERARCHICAL, and by NEXT_HOP_TABLE until its table is ready.
+// INCREMENTAL and FLOW_FIELD never search for a whole path, so they don't use it.
+static PATHFINDING_MODE const ENEMY_PATHFINDING_MODE = PATHFINDING_MODE::A_STAR;
+
+// The time in microseconds that enemy searches can use each frame. Searches that don't fit carry on in the next frame.
+// 0 runs every search as soon as it's requested. Either way the searches run across the worker threads.
+// Only the modes that search are queued: A_STAR, JUMP_POINT_SEARCH, HIERARCHICAL, and NEXT_HOP_TABLE until its table is ready.
+static int const ENEMY_PATHFINDING_BUDGET = 1000;
+
+// Whether each floor is one endless level streamed in chunks around the player, rather than a series of rooms.
+static bool const LEVEL_STREAMING_ENABLED = false;
+
 static int const AMBIENT_SOUNDS_COUNT = 3;
 static float const GAME_OVER_TEXT_SHIFT = 50.f;
 
@@ -39,8 +54,9 @@ public:
 	/**
 	 * Constructor.
 	 * @param window A pointer to the main render window.
+	 * @param seed The seed of the run. The same seed always gives the same dungeon.
 	 */
-	Game(sf::RenderWindow* window);
+	Game(sf::RenderWindow* window, std::uint64_t seed);
 
 	/**
 	 * Initializes the game object by initializing all objects the main game uses.
@@ -72,12 +88,19 @@ public:
 	 */
 	void Draw(float timeDelta);
 
+	/**
+	 * Gets the number of enemy pathfinding searches that were skipped because the enemy could move straight to the player.
+	 * @return The number of skipped searches since the game started.
+	 */
+	long long GetAvoidedSearchCount() const;
+
 private:
 
 	/**
 	 * Populates the current game room with items and enemies.
+	 * @param spawnPlan The items and enemies chosen for the room, and where they go.
 	 */
-	void PopulateLevel();
+	void PopulateLevel(const SpawnPlan& spawnPlan);
 
 	/**
 	 * Loads all sprites needed for the UI.
@@ -134,9 +157,10 @@ private:
     /**
      * Spawns a given item in the level.
      * @param itemType Item what need to generated on the level.
+     * @param random The random number stream to choose the item's values with.
      * @param position The position of the item within the level.
      */
-	void SpawnItem(ITEM itemType, sf::Vector2f position = { -1.f, -1.f });
+	void SpawnItem(ITEM itemType, Random& random, sf::Vector2f position = { -1.f, -1.f });
 
     /**
      * Spawns a given enemy in the level.
@@ -166,6 +190,30 @@ private:
      * Generates a game level.
      */
 	void GenerateLevel();
+
+	/**
+	 * Creates an empty level, the right size for the kind of floor being played.
+	 * @return The new level.
+	 */
+	Level CreateLevel();
+
+	/**
+	 * Removes the enemies, items, and projectiles that are no longer inside the level, such as after a streamed level moves.
+	 */
+	void RemoveObjectsOutsideLevel();
+
+	/**
+	 * Starts a new run from a seed, seeding the level and the random number streams that last the whole run.
+	 * @param seed The seed of the run.
+	 */
+	void SeedRun(std::uint64_t seed);
+
+	/**
+	 * Gets one of the game's random number streams.
+	 * @param stream The stream to get.
+	 * @return The stream.
+	 */
+	Random& GetRandomStream(RANDOM_STREAM stream);
 private:
 	/**
 	 * The main application window.
@@ -212,6 +260,73 @@ private:
 	 */
 	Level m_level;
 
+	/**
+	 * The pool of worker threads that runs the enemy pathfinding searches.
+	 * With a budget it runs the scheduler's searches a group at a time, and otherwise all of the current frame's searches at once.
+	 */
+	PathfindingBatch m_pathfindingBatch;
+
+	/**
+	 * The enemy that each request in the pathfinding batch is for.
+	 */
+	std::vector<Enemy*> m_pathfindingEnemies;
+
+	/**
+	 * The enemy pathfinding searches waiting to run, spread over frames to keep within the time budget.
+	 */
+	PathfindingScheduler m_pathfindingScheduler;
+
+
+	/**
+	 * The distance field towards the player's tile, shared by all enemies.
+	 */
+	FlowField m_flowField;
+
+	/**
+	 * The abstract graph of the level used for hierarchical enemy pathfinding.
+	 */
+	PathfindingHierarchy m_pathfindingHierarchy;
+
+	/**
+	 * The most recently found enemy paths, shared by enemies that search from the same tile.
+	 */
+	PathCache m_pathCache;
+
+	/**
+	 * The first step between every pair of tiles, built in the background after the level is generated.
+	 */
+	NextHopTable m_nextHopTable;
+
+	/**
+	 * The solid tiles of the level, used to send enemies straight at the player when nothing is in the way.
+	 */
+	LineOfSight m_lineOfSight;
+
+	/**
+	 * The number of enemy searches that weren't needed because the enemy could move straight to the player.
+	 */
+	long long m_avoidedSearchCount;
+
+	/**
+	 * Generates the next room on a worker thread while the current one is played.
+	 */
+	LevelGenerator m_levelGenerator;
+
+	/**
+	 * Streams the chunks of an endless floor in and out around the player.
+	 */
+	LevelStreamer m_levelStreamer;
+
+	/**
+	 * The seed of the current run.
+	 */
+	std::uint64_t m_seed;
+
+	/**
+	 * The game's random number streams. The level and spawn streams are kept by the level and level generator.
+	 */
+	Random m_randomStreams[static_cast<int>(RANDOM_STREAM::COUNT)];
+
 	/**
 	 * The main player object. Only one instance of this object should be created at any one time.
 	 */
@@ -12,14 +12,16 @@
 #define GEM_H
 
 #include "Item.h"
+#include "Random.h"
 
 class Gem : public Item
 {
 public:
 	/**
-	 * Default constructor.
+	 * Constructor.
+	 * @param random The random number stream to choose the gem's values with.
 	 */
-	Gem();
+	explicit Gem(Random& random);
 
 	/**
 	 * Gets the amount of score this pickup gives.
@@ -12,14 +12,16 @@
 #define GOLD_H
 
 #include "Item.h"
+#include "Random.h"
 
 class Gold : public Item
 {
 public:
 	/**
-	 * Default constructor.
+	 * Constructor.
+	 * @param random The random number stream to choose the gold's values with.
 	 */
-	Gold();
+	explicit Gold(Random& random);
 
 	/**
 	 * Gets the amount of gold this pickup has.
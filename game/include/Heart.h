@@ -12,15 +12,17 @@
 #define HEART_H
 
 #include "Item.h"
+#include "Random.h"
 
 class Heart : public Item
 {
 public:
 
 	/**
-	 * Default constructor.
+	 * Constructor.
+	 * @param random The random number stream to choose the heart's values with.
 	 */
-	Heart();
+	explicit Heart(Random& random);
 
 	/**
 	 * Returns the amount of health that the heart gives.
@@ -18,8 +18,9 @@ class Humanoid : public Enemy
 public:
 
 	/**
-	 * Default constructor
+	 * Constructor.
+	 * @param random The random number stream to choose the humanoid's type and stats with.
 	 */
-	Humanoid();
+	explicit Humanoid(Random& random);
 };
 #endif
\ No newline at end of file
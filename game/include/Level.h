@@ -11,48 +11,101 @@
 #ifndef LEVEL_H
 #define LEVEL_H
 
+#include "LevelPack.h"
+#include "Random.h"
+#include "TileBitboard.h"
 #include "Torch.h"
 
-// Constants for the game grid size.
+// The default size of the game grid.
 static int const GRID_WIDTH = 25;
 static int const GRID_HEIGHT = 25;
 
+// The smallest grid that a level can be generated in. Grid sizes are rounded up to odd numbers so the maze has walls all round.
+static int const GRID_MIN_SIZE = 5;
+
 // Room count for procedurally generated level.
 static int const ROOMS_COUNT = 15;
 
+// The number of rooms on each floor.
+static int const ROOMS_PER_FLOOR = 5;
+
 // Torches count per generated level.
 static int const TORCHES_COUNT = 10;
 
 // The width and height of each tile in pixels.
 static int const TILE_SIZE = 50;
 
+// The number of tile changes that are remembered before the level reports a full layout change instead.
+static int const MAX_TRACKED_TILE_CHANGES = 1024;
+
+// Flags for how each type of tile behaves, as held in TILE_PROPERTIES.
+static std::uint8_t const TILE_FLAG_SOLID = 1 << 0;		// Blocks movement.
+static std::uint8_t const TILE_FLAG_FLOOR = 1 << 1;		// Can be walked on and pathed through.
+static std::uint8_t const TILE_FLAG_WALL = 1 << 2;		// A wall, whose type depends on the walls around it.
+static std::uint8_t const TILE_FLAG_DOOR = 1 << 3;		// The exit door, locked or not.
+
+// The flags of each type of tile, in the order of the TILE enum.
+static constexpr std::uint8_t TILE_PROPERTIES[] = {
+	TILE_FLAG_SOLID | TILE_FLAG_WALL,	// WALL_SINGLE
+	TILE_FLAG_SOLID | TILE_FLAG_WALL,	// WALL_TOP_END
+	TILE_FLAG_SOLID | TILE_FLAG_WALL,	// WALL_SIDE_RIGHT_END
+	TILE_FLAG_SOLID | TILE_FLAG_WALL,	// WALL_BOTTOM_LEFT
+	TILE_FLAG_SOLID | TILE_FLAG_WALL,	// WALL_BOTTOM_END
+	TILE_FLAG_SOLID | TILE_FLAG_WALL,	// WALL_SIDE
+	TILE_FLAG_SOLID | TILE_FLAG_WALL,	// WALL_TOP_LEFT
+	TILE_FLAG_SOLID | TILE_FLAG_WALL,	// WALL_SIDE_LEFT_T
+	TILE_FLAG_SOLID | TILE_FLAG_WALL,	// WALL_SIDE_LEFT_END
+	TILE_FLAG_SOLID | TILE_FLAG_WALL,	// WALL_BOTTOM_RIGHT
+	TILE_FLAG_SOLID | TILE_FLAG_WALL,	// WALL_TOP
+	TILE_FLAG_SOLID | TILE_FLAG_WALL,	// WALL_BOTTOM_T
+	TILE_FLAG_SOLID | TILE_FLAG_WALL,	// WALL_TOP_RIGHT
+	TILE_FLAG_SOLID | TILE_FLAG_WALL,	// WALL_SIDE_RIGHT_T
+	TILE_FLAG_SOLID | TILE_FLAG_WALL,	// WALL_TOP_T
+	TILE_FLAG_SOLID | TILE_FLAG_WALL,	// WALL_INTERSECTION
+	TILE_FLAG_SOLID | TILE_FLAG_DOOR,	// WALL_DOOR_LOCKED
+	TILE_FLAG_DOOR,						// WALL_DOOR_UNLOCKED
+	TILE_FLAG_SOLID,					// WALL_ENTRANCE
+	TILE_FLAG_FLOOR,					// FLOOR
+	TILE_FLAG_FLOOR,					// FLOOR_ALT
+	TILE_FLAG_SOLID						// EMPTY
+};
+static_assert(sizeof(TILE_PROPERTIES) == static_cast<size_t>(TILE::COUNT), "Every type of tile needs an entry in TILE_PROPERTIES.");
+
+/**
+ * Checks whether a type of tile has any of the given flags.
+ * @param type The type of tile to check.
+ * @param flags The TILE_FLAG values to look for.
+ * @return True if the type has at least one of the flags.
+ */
+inline constexpr bool HasTileFlag(TILE type, std::uint8_t flags)
+{
+	return (TILE_PROPERTIES[static_cast<int>(type)] & flags) != 0;
+}
+
 
-// The level tile type.
+// A tile in the level, as handed to pathfinding. Its type and sprite are held by the level, and looked up by its indices.
 struct Tile {
-	TILE type;							// The type of tile this is.
 	int columnIndex;					// The column index of the tile.
 	int rowIndex;						// The row index of the tile.
-	sf::Sprite sprite;					// The tile sprite.
-	int H;								// Heuristic / movement cost to goal.
-	int G;								// Movement cost. (Total of entire path)
-	int F;								// Estimated cost for full path. (G + H)
-	Tile* parentNode;					// Node to reach this node.
 };
 
 class Level
 {
 public:
 	/**
-	 * Default constructor.
+	 * Constructor.
+	 * Creates a level without a window or tile textures, for headless tools.
+	 * @param size The number of columns and rows in the level. Each is rounded up to an odd number of at least GRID_MIN_SIZE.
 	 */
-	Level();
+	explicit Level(sf::Vector2i size = sf::Vector2i(GRID_WIDTH, GRID_HEIGHT));
 
 	/** 
 	 * Constructor.
 	 * A renderWindow is needed in order for the level to calculate its position.
 	 * @param window The game window.
+	 * @param size The number of columns and rows in the level. Each is rounded up to an odd number of at least GRID_MIN_SIZE.
 	 */
-	Level(sf::RenderWindow& window);
+	Level(sf::RenderWindow& window, sf::Vector2i size = sf::Vector2i(GRID_WIDTH, GRID_HEIGHT));
 
 	/**
 	 * Returns true if the given tile index is solid.
@@ -65,6 +118,8 @@ public:
 	/**
 	 * Sets the index of a given tile in the 2D game grid.
 	 * This also changes the tile sprite, and is how tiles should be changed and set manually.
+	 * Walls take their type from the walls beside them, so if the tile becomes or stops being a wall, the four walls beside it are updated too.
+	 * Only the tiles whose type changes are recorded for GetChangedTiles().
 	 * @param columnIndex The tile's column index.
 	 * @param rowIndex The tile's row index.
 	 * @param index The new index of the tile.
@@ -87,12 +142,29 @@ public:
 	TILE GetTileType(int columnIndex, int rowIndex) const;
 
 	/**
-	 * Loads a level from a text file.
+	 * Loads a level from a binary level file, as written by LevelFile. The level takes the size of the one in the file.
+	 * Text levels can be converted with the level_converter tool.
+	 * No textures are touched. BindSprites() must be called before the level is drawn.
 	 * @param fileName The path to the level file to load.
 	 * return true if the level loaded succesfully.
 	 */
 	bool LoadLevelFromFile(std::string fileName);
 
+	/**
+	 * Loads a level from a level pack, in the same way as LoadLevelFromFile(). The level takes the size of the one in the pack.
+	 * @param pack The open level pack.
+	 * @param levelID The ID of the level in the pack.
+	 * @return True if the pack holds a valid level with the given ID.
+	 */
+	bool LoadLevelFromPack(const LevelPack& pack, int levelID);
+
+	/**
+	 * Builds the level in the binary level format, so it can be written to a file or a pack and loaded again.
+	 * The spawn table is left empty if the spawn location isn't on the level.
+	 * @param data Receives the level.
+	 */
+	void Serialize(std::vector<unsigned char>& data) const;
+
 	/**
 	 * Gets the tile at the given position.
 	 * @param position The coordinates of the position to check.
@@ -100,6 +172,13 @@ public:
 	 */
 	Tile* GetTile(sf::Vector2f position);
 
+	/**
+	 * Gets the tile at the given position.
+	 * @param position The coordinates of the position to check.
+	 * @return A const pointer to the tile at the given location.
+	 */
+	const Tile* GetTile(sf::Vector2f position) const;
+
 	/**
 	* Gets the tile at the given position in the level array.
 	* @param columnIndex The column that the tile is in.
@@ -108,6 +187,14 @@ public:
 	*/
 	Tile* GetTile(int columnIndex, int rowIndex);
 
+	/**
+	* Gets the tile at the given position in the level array.
+	* @param columnIndex The column that the tile is in.
+	* @param rowIndex The row that the tile is in.
+	* @return A const pointer to the tile if valid.
+	*/
+	const Tile* GetTile(int columnIndex, int rowIndex) const;
+
 	/**
 	 * Gets the position of the level grid relative to the window.
 	 * @return The position of the top-left of the level grid.
@@ -120,13 +207,26 @@ public:
 	 */
 	std::vector<std::shared_ptr<Torch>>* GetTorches();
 
+	/**
+	 * Gets where the torches in the level go. Unlike GetTorches(), these are known as soon as the layout is generated.
+	 * @return The centre of each tile that has a torch.
+	 */
+	const std::vector<sf::Vector2f>& GetTorchLocations() const;
+
 	/**
 	 * Checks if a given tile is valid.
 	 * @param columnIndex The column that the tile is in.
 	 * @param rowIndex The column that the row is in.
 	 * @return True if the tile is valid.
 	 */
-	bool TileIsValid(int columnIndex, int rowIndex);
+	bool TileIsValid(int columnIndex, int rowIndex) const;
+
+	/**
+	 * Checks if a position lies on one of the level's tiles.
+	 * @param position The position to check.
+	 * @return True if the position is inside the level.
+	 */
+	bool IsInside(sf::Vector2f position) const;
 
 	/**
 	 * Gets the current floor number.
@@ -140,11 +240,67 @@ public:
 	 */
 	int GetRoomNumber() const;
 
+	/**
+	 * Gets the index of the current room in the run, counting every room on every floor.
+	 * @return The index of the room. 0 before the first room is generated.
+	 */
+	int GetRoomIndex() const;
+
+	/**
+	 * Gets the seed of the run that the level belongs to.
+	 * @return The seed that every room is generated from.
+	 */
+	std::uint64_t GetSeed() const;
+
+	/**
+	 * Sets the seed of the run that the level belongs to, and picks the tile color of the first floor with it.
+	 * Every room generated afterwards only depends on the seed and the index of the room.
+	 * @param seed The seed of the run.
+	 */
+	void SetSeed(std::uint64_t seed);
+
     /**
-     * Get the reachable tiles on the level.
-     * @return Reachable tiles.
+     * Get the reachable tiles on the level: the floor tiles that can be walked to from the spawn tile.
+     * They are found with a flood fill, which only runs again once the walkable tiles have changed. If the spawn tile isn't a floor tile on the level, every floor tile counts as reachable.
+     * @return The centre of each reachable tile, in order of column then row.
      */
-    const std::vector<sf::Vector2f> GetReachableTiles() const;
+    const std::vector<sf::Vector2f>& GetReachableTiles() const;
+
+	/**
+	 * Gets the reachable tiles on the level, one bit per tile. It is worked out along with GetReachableTiles().
+	 * @return The bitboard of tiles that can be walked to from the spawn tile.
+	 */
+	const TileBitboard& GetReachableMask() const;
+
+	/**
+	 * Checks if a tile can be walked to from the spawn tile.
+	 * @param columnIndex The column that the tile is in.
+	 * @param rowIndex The row that the tile is in.
+	 * @return True if the tile is reachable. Tiles outside the level never are.
+	 */
+	bool IsReachable(int columnIndex, int rowIndex) const;
+
+	/**
+	 * Gets the revision of the level layout. It changes every time a tile is set or the level is replaced.
+	 * @return The current layout revision.
+	 */
+	unsigned int GetLayoutRevision() const;
+
+	/**
+	 * Gets the tiles that have been set since the given layout revision, including walls that changed type because of a tile set beside them.
+	 * Anything derived from the layout can use this to update only the parts that changed.
+	 * @param revision A revision previously returned by GetLayoutRevision().
+	 * @param tiles Receives the column and row of each tile that was set. A tile can appear more than once.
+	 * @return False if the whole layout has been replaced since the revision, in which case it should be rebuilt instead.
+	 */
+	bool GetChangedTiles(unsigned int revision, std::vector<sf::Vector2i>& tiles) const;
+
+	/**
+	 * Gets the revision of the walkable tiles in the level.
+	 * It only changes when a floor tile becomes solid or a solid tile becomes floor, or the level is replaced.
+	 * @return The current walkability revision.
+	 */
+	unsigned int GetWalkabilityRevision() const;
 
 	/**
 	 * Gets the size of the level in terms of tiles.
@@ -152,6 +308,24 @@ public:
 	 */
 	sf::Vector2i GetSize() const;
 
+	/**
+	 * Gets the floor tiles of the level, one bit per tile. It is kept in step with the tiles as they are set.
+	 * @return The bitboard of tiles that can be walked on.
+	 */
+	const TileBitboard& GetWalkableTiles() const;
+
+	/**
+	 * Gets the wall tiles of the level, one bit per tile. It is kept in step with the tiles as they are set.
+	 * @return The bitboard of wall tiles, not counting doors and the entrance.
+	 */
+	const TileBitboard& GetWallTiles() const;
+
+	/**
+	 * Gets the door tiles of the level, one bit per tile. It is kept in step with the tiles as they are set.
+	 * @return The bitboard of door tiles, locked or not.
+	 */
+	const TileBitboard& GetDoorTiles() const;
+
 	/**
 	 * Spawns a given number of torches in the level.
 	 * @param torchCount The number of torches to create.
@@ -159,7 +333,7 @@ public:
 	void SpawnTorches(int torchCount);
 
 	/**
-	 * Unlocks the door in the level.
+	 * Unlocks the door in the level. Nothing happens if the level has no locked door.
 	 */
 	void UnlockDoor();
 
@@ -169,14 +343,14 @@ public:
 	 * @param rowIndex The column that the row is in.
 	 * @return True if the given tile is a floor tile.
 	 */
-	bool IsFloor(int columnIndex, int rowIndex);
+	bool IsFloor(int columnIndex, int rowIndex) const;
 
 	/**
 	* Return true if the given tile is a floor tile.
 	* @param tile The tile to check
 	* @return True if the given tile is a floor tile.
 	*/
-	bool IsFloor(const Tile& tile);
+	bool IsFloor(const Tile& tile) const;
 
 	/**
 	 * Returns the size of the tiles in the level.
@@ -209,9 +383,10 @@ public:
 
     /**
      * Get random reachable location
+     * @param random The random number stream to choose the location with.
      * @return Returns a valid spawn location from the currently loaded level.
      */
-    sf::Vector2f GetRandomSpawnLocation();
+    sf::Vector2f GetRandomSpawnLocation(Random& random);
 
     /**
      * Sets the overlay color of the level tiles.
@@ -219,20 +394,62 @@ public:
      */
 	void SetColor(sf::Color tileColor);
 
-	/**
-     * Resets the A* data of all level tiles.
+    /**
+     * Generates the next room of the run.
      */
-	void ResetNodes();
+    void GenerateLevel();
 
     /**
-     * Generates a random level.
+     * Generates the layout of the next room of the run without touching any textures.
+     * This makes it safe to call on a worker thread for a level that no other thread is using.
+     * BindSprites() must be called on the main thread before the level is drawn.
+     * The layout only depends on the seed of the run and the index of the room.
      */
-    void GenerateLevel();
+    void GenerateLayout();
+
+    /**
+     * Sets the sprite of every tile to match its type, and creates the torches chosen by the layout.
+     */
+    void BindSprites();
+
+    /**
+     * Checks if the level has sprites or torches, which are only safe to touch on the main thread.
+     * @return True if BindSprites() has been called since the level was last cleared.
+     */
+    bool HasSprites() const;
 
     /**
-     * Calculates the correct texture for each tile in the level.
+     * Copies everything but the layout from another level, such as its size, position, textures, seed, and room number.
+     * The next room can then be generated from it without copying all of its tiles.
+     * Any sprites and torches are dropped, so the level can be handed to a worker thread.
+     * @param other The level to copy from.
      */
-    void CalculateTextures();
+    void CopySettings(const Level& other);
+
+    /**
+     * Replaces this level with another one, such as a level generated on a worker thread. The other level is left with the old contents.
+     * The layout revisions move on from both levels, so anything built from the old level sees the change.
+     * @param other The level to take the contents of.
+     */
+    void ReplaceWith(Level& other);
+
+    /**
+     * Replaces the whole layout with the given tiles and moves the level to a new position, such as when a streamed level follows the player.
+     * The wall types are calculated again, so walls can be given as any wall type.
+     * The old sprites are dropped, and BindSprites() must be called before the level is drawn.
+     * @param position The new top-left of the level grid.
+     * @param tiles The type of every tile, indexed by column * height + row.
+     * @param spawnLocation The position that the reachable tiles are filled out from, such as the player's.
+     */
+    void LoadLayout(sf::Vector2i position, const std::vector<TILE>& tiles, sf::Vector2f spawnLocation);
+
+    /**
+     * Calculates the correct wall type for each tile in the level, from the walls beside it.
+     * The sprites of walls whose type changes are updated, if the level has sprites.
+     * The wall bitboard must be up to date, which it is unless tiles have been written without SetTile().
+     * @return The number of walls whose type changed.
+     */
+    int CalculateTextures();
 
     /**
      * Set a random color for the generated level;
@@ -250,7 +467,7 @@ public:
     sf::Vector2f SpawnLocation();
 
     /**
-     * Generates an torches for the given level.
+     * Chooses where the torches go in the given level. They are created by BindSprites().
      */
     void GenerateTorches();
 private:
@@ -264,7 +481,10 @@ private:
 	bool IsWall(int columnIndex, int rowIndex);
 
     /**
-     * Creates a path between two nodes in the recursive backtracker algorithm.
+     * Carves the maze passages out from a tile with the recursive backtracker algorithm.
+     * The backtracking uses its own stack rather than recursion, so any size of level can be generated.
+     * @param columnIndex The column of the tile to start from.
+     * @param rowIndex The row of the tile to start from.
      */
     void CreatePath(int columnIndex, int rowIndex);
 
@@ -272,24 +492,96 @@ private:
      * Adds a given number of randomly sized rooms to the level to create some open space.
      */
     void CreateRooms(int roomCount);
+
+	/**
+	 * Records that the whole layout has been replaced, and forgets the individual tile changes.
+	 */
+	void ResetLayoutRevision();
+
+	/**
+	 * Sets the sprite of a tile to match its type, if the level has sprites, and records that it changed.
+	 * @param columnIndex The column that the tile is in.
+	 * @param rowIndex The row that the tile is in.
+	 */
+	void RefreshTile(int columnIndex, int rowIndex);
+
+	/**
+	 * Sets the type of a tile and updates the bitboards, without touching its sprite or recording the change.
+	 * @param columnIndex The column that the tile is in.
+	 * @param rowIndex The row that the tile is in.
+	 * @param tileType The new type of the tile.
+	 */
+	void SetTileType(int columnIndex, int rowIndex, TILE tileType);
+
+	/**
+	 * Builds the bitboards from the tile types, after the layout has been written directly.
+	 */
+	void BuildBitboards();
+
+	/**
+	 * Changes the number of columns and rows in the level, keeping it centred where it was. Every tile is left empty.
+	 * @param size The new number of columns and rows.
+	 */
+	void Resize(sf::Vector2i size);
+
+	/**
+	 * Builds the level from a binary level that has been checked, taking its size, tiles, torches, and spawn tile.
+	 * @param file The level to build from.
+	 */
+	void LoadLevel(const LevelFile& file);
+
+	/**
+	 * Gets the tile that the player spawns on.
+	 * @param tile Receives the column and row of the tile.
+	 * @return False if the spawn location isn't on the level, such as when the level has no spawn tile.
+	 */
+	bool GetSpawnTile(sf::Vector2i& tile) const;
+
+	/**
+	 * Works out the reachable tiles with a flood fill from the spawn tile, if the walkable tiles have changed since they were last worked out.
+	 */
+	void UpdateReachableTiles() const;
 private:
 	/**
-	 * A 2D array that describes the level data.
-	 * The type is Tile, which holds a sprite and an index.
+	 * The number of columns and rows in the level.
 	 */
-	Tile m_grid[GRID_WIDTH][GRID_HEIGHT];
+	sf::Vector2i m_size;
 
 	/**
-	 * A vector off all the sprites in the level.
+	 * The indices of every tile, indexed by column * height + row, so tiles can be handed out by pointer.
+	 */
+	std::vector<Tile> m_grid;
+
+	/**
+	 * The type of every tile, indexed by column * height + row.
+	 * This is kept apart from the sprites so that checking tiles only touches one byte each.
+	 */
+	std::vector<TILE> m_tileTypes;
+
+	/**
+	 * The sprite of every tile, indexed like the types. They are only created once the level is drawn.
 	 */
 	std::vector<sf::Sprite> m_tileSprites;
 
+	/**
+	 * The floor, wall, and door tiles, one bit per tile, built from the tile types.
+	 */
+	TileBitboard m_walkableTiles;
+	TileBitboard m_wallTiles;
+	TileBitboard m_doorTiles;
+
 
     /**
-     *  A vector with locations of all reachable tiles on the map.
-     *  Internally used for random objects spawning.
+     *  A vector with locations of all reachable tiles on the map, and the same tiles one bit per tile.
+     *  Internally used for random objects spawning. They are worked out when first asked for, so they are mutable.
      */
-    std::vector<sf::Vector2f> m_reachableTiles;
+    mutable std::vector<sf::Vector2f> m_reachableTiles;
+	mutable TileBitboard m_reachableMask;
+
+	/**
+	 * The walkability revision that the reachable tiles were worked out for.
+	 */
+	mutable unsigned int m_reachableRevision;
 
 	/**
 	 * The position of the level relative to the window.
@@ -327,9 +619,49 @@ private:
 	 */
 	std::vector<std::shared_ptr<Torch>> m_torches;
 
+	/**
+	 * The locations of the torches chosen by the layout.
+	 */
+	std::vector<sf::Vector2f> m_torchLocations;
+
+	/**
+	 * The seed of the run that the level belongs to.
+	 */
+	std::uint64_t m_seed;
+
+	/**
+	 * The random number stream that the layout is made with, seeded for each room.
+	 */
+	Random m_random;
+
+	/**
+	 * The overlay color of the level tiles.
+	 */
+	sf::Color m_tileColor;
+
     /**
      * The spawn location for the current level.
      */
     sf::Vector2f m_spawnLocation;
+
+	/**
+	 * The current revision of the level layout.
+	 */
+	unsigned int m_layoutRevision;
+
+	/**
+	 * The revision at which the whole layout was last replaced.
+	 */
+	unsigned int m_layoutResetRevision;
+
+	/**
+	 * The current revision of the walkable tiles in the level.
+	 */
+	unsigned int m_walkabilityRevision;
+
+	/**
+	 * The tiles set since the layout was last replaced, in order. Entry i was made in revision m_layoutResetRevision + i + 1.
+	 */
+	std::vector<sf::Vector2i> m_changedTiles;
 };
 #endif
\ No newline at end of file
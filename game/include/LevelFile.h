@@ -0,0 +1,182 @@
+//-------------------------------------------------------------------------------------
+// LevelFile.h
+//
+// THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A
+// PARTICULAR PURPOSE.
+//
+// Written by Dale Green. Copyright (c) Packt Publishing. All rights reserved.
+//-------------------------------------------------------------------------------------
+#ifndef LEVELFILE_H
+#define LEVELFILE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "MappedFile.h"
+
+// The first bytes of every binary level file.
+static char const LEVEL_FILE_MAGIC[4] = { 'D', 'P', 'L', 'V' };
+
+// The version of the binary level format. Files of any other version are rejected.
+static std::uint32_t const LEVEL_FILE_VERSION = 1;
+
+// The largest number of columns or rows a level file can have.
+static std::uint32_t const LEVEL_FILE_MAX_SIZE = 4096;
+
+
+/**
+ * The header at the start of a binary level file. Every field is little-endian.
+ * It is followed by the tiles, one byte each indexed by column * rowCount + row, padded with zeros to a multiple of 4 bytes.
+ * After them come the torch table and the spawn table, each a list of column and row pairs stored as 32-bit integers.
+ */
+struct LevelFileHeader
+{
+	char magic[4];						// LEVEL_FILE_MAGIC.
+	std::uint32_t version;				// LEVEL_FILE_VERSION.
+	std::uint32_t columnCount;			// The number of columns of tiles.
+	std::uint32_t rowCount;				// The number of rows of tiles.
+	std::uint32_t torchCount;			// The number of tiles in the torch table.
+	std::uint32_t spawnCount;			// The number of tiles in the spawn table.
+	std::uint32_t checksum;				// The FNV-1a hash of everything after the header.
+	std::uint32_t reserved;				// Always 0.
+};
+static_assert(sizeof(LevelFileHeader) == 32, "The level file header must have no padding.");
+
+class LevelFile
+{
+public:
+	/**
+	 * Default constructor. No level is open until Open() or Read() is called.
+	 */
+	LevelFile();
+
+	/**
+	 * Maps a binary level file and checks it. The tiles are read straight from the mapping rather than copied.
+	 * @param fileName The path to the level file.
+	 * @return True if the file is a valid level of the current version.
+	 */
+	bool Open(const std::string& fileName);
+
+	/**
+	 * Checks a binary level held in memory, such as one inside a level pack. The memory must stay valid while the level is used.
+	 * @param data The first byte of the level.
+	 * @param size The size of the level in bytes.
+	 * @return True if the data is a valid level of the current version.
+	 */
+	bool Read(const unsigned char* data, size_t size);
+
+	/**
+	 * Gets the size of the level.
+	 * @return The number of columns and rows.
+	 */
+	sf::Vector2i GetSize() const;
+
+	/**
+	 * Gets the tiles of the level, which point into the file.
+	 * @return The TILE of each tile as one byte, indexed by column * height + row.
+	 */
+	const std::uint8_t* GetTiles() const;
+
+	/**
+	 * Gets the number of torches in the level.
+	 * @return The number of entries in the torch table.
+	 */
+	int GetTorchCount() const;
+
+	/**
+	 * Gets the tile that a torch is on.
+	 * @param index The index of the torch, below GetTorchCount().
+	 * @return The column and row of the tile.
+	 */
+	sf::Vector2i GetTorch(int index) const;
+
+	/**
+	 * Gets the number of player spawn tiles in the level.
+	 * @return The number of entries in the spawn table.
+	 */
+	int GetSpawnCount() const;
+
+	/**
+	 * Gets a tile that the player can spawn on.
+	 * @param index The index of the spawn tile, below GetSpawnCount().
+	 * @return The column and row of the tile.
+	 */
+	sf::Vector2i GetSpawn(int index) const;
+
+	/**
+	 * Builds a binary level.
+	 * @param size The number of columns and rows.
+	 * @param tiles The type of every tile, indexed by column * height + row.
+	 * @param torches The tiles that torches are on.
+	 * @param spawns The tiles that the player can spawn on.
+	 * @param data Receives the level.
+	 */
+	static void Serialize(sf::Vector2i size, const std::vector<TILE>& tiles, const std::vector<sf::Vector2i>& torches, const std::vector<sf::Vector2i>& spawns, std::vector<unsigned char>& data);
+
+	/**
+	 * Writes a binary level file.
+	 * @param fileName The path to write to.
+	 * @param size The number of columns and rows.
+	 * @param tiles The type of every tile, indexed by column * height + row.
+	 * @param torches The tiles that torches are on.
+	 * @param spawns The tiles that the player can spawn on.
+	 * @return True if the file was written.
+	 */
+	static bool Write(const std::string& fileName, sf::Vector2i size, const std::vector<TILE>& tiles, const std::vector<sf::Vector2i>& torches, const std::vector<sf::Vector2i>& spawns);
+
+	/**
+	 * Reads a level in the old text format, where each row is a line of tile IDs in brackets, such as [05][19].
+	 * @param fileName The path to the text file.
+	 * @param size Receives the number of columns and rows.
+	 * @param tiles Receives the type of every tile, indexed by column * height + row.
+	 * @return True if every row had the same number of valid tiles.
+	 */
+	static bool ReadTextLevel(const std::string& fileName, sf::Vector2i& size, std::vector<TILE>& tiles);
+
+	/**
+	 * Converts a level in the old text format to a binary level file.
+	 * The text format has no torches or spawns, so the torches are put where the text loader put them, and the player spawns in front of the entrance.
+	 * @param textFileName The path to the text file.
+	 * @param fileName The path to write the binary file to.
+	 * @return True if the text level was valid and the binary file was written.
+	 */
+	static bool ConvertTextLevel(const std::string& textFileName, const std::string& fileName);
+
+	/**
+	 * Calculates the checksum that binary levels use.
+	 * @param data The first byte to hash.
+	 * @param size The number of bytes to hash.
+	 * @return The 32-bit FNV-1a hash of the bytes.
+	 */
+	static std::uint32_t CalculateChecksum(const unsigned char* data, size_t size);
+
+private:
+	/**
+	 * Reads one entry of the torch or spawn table.
+	 * @param table The first byte of the table.
+	 * @param index The index of the entry.
+	 * @return The column and row of the entry.
+	 */
+	static sf::Vector2i ReadLocation(const unsigned char* table, int index);
+
+private:
+	/**
+	 * The file the level was opened from, if it wasn't read from memory.
+	 */
+	MappedFile m_file;
+
+	/**
+	 * The header of the level.
+	 */
+	LevelFileHeader m_header;
+
+	/**
+	 * The tiles, torch table, and spawn table, which all point into the level's data.
+	 */
+	const std::uint8_t* m_tiles;
+	const unsigned char* m_torches;
+	const unsigned char* m_spawns;
+};
+#endif
\ No newline at end of file
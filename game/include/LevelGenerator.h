@@ -0,0 +1,109 @@
+//-------------------------------------------------------------------------------------
+// LevelGenerator.h
+//
+// THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A
+// PARTICULAR PURPOSE.
+//
+// Written by Dale Green. Copyright (c) Packt Publishing. All rights reserved.
+//-------------------------------------------------------------------------------------
+#ifndef LEVELGENERATOR_H
+#define LEVELGENERATOR_H
+
+#include <atomic>
+#include <thread>
+#include "Level.h"
+
+// The number of times an item or enemy may spawn in a room. Each has a one in two chance.
+static int const MAX_ITEM_SPAWN_COUNT = 50;
+static int const MAX_ENEMY_SPAWN_COUNT = 30;
+
+
+// The items and enemies to spawn in a room, chosen along with its layout.
+struct SpawnPlan
+{
+	sf::Vector2f keyLocation;
+	std::vector<std::pair<ITEM, sf::Vector2f>> items;
+	std::vector<std::pair<ENEMY, sf::Vector2f>> enemies;
+};
+
+
+class LevelGenerator
+{
+public:
+	/**
+	 * Default constructor.
+	 */
+	LevelGenerator();
+
+	/**
+	 * Destructor.
+	 * Waits for a background generation to finish.
+	 */
+	~LevelGenerator();
+
+	/**
+	 * Starts generating the room after the given one on a background thread, replacing any room that has already been generated.
+	 * The level's settings are copied first, so it can be played while the next room is generated.
+	 * @param level The level being played.
+	 */
+	void Start(const Level& level);
+
+	/**
+	 * Waits for a background generation to finish, and throws away the room it made.
+	 */
+	void Cancel();
+
+	/**
+	 * Checks if a room has been started and not yet taken.
+	 * @return True if Finish() can be called.
+	 */
+	bool IsStarted() const;
+
+	/**
+	 * Swaps the generated room into a level, waiting for it first if it isn't finished yet.
+	 * Only the tile sprites and torches are set up on the calling thread.
+	 * @param level The level to replace with the generated room.
+	 * @param spawnPlan Filled with the items and enemies to spawn in the room.
+	 */
+	void Finish(Level& level, SpawnPlan& spawnPlan);
+
+	/**
+	 * Gets the time the last background generation took.
+	 * @return The generation time in microseconds.
+	 */
+	long long GetGenerationTime() const;
+
+	/**
+	 * Gets the time the last call to Finish() took, including any wait for the background generation.
+	 * @return The time in microseconds.
+	 */
+	long long GetFinishTime() const;
+
+	/**
+	 * Chooses the items and enemies to spawn in a level, using the spawn stream of the level's seed and room.
+	 * @param level The level to spawn in.
+	 * @param spawnPlan Filled with the items and enemies to spawn.
+	 */
+	static void PlanSpawns(Level& level, SpawnPlan& spawnPlan);
+
+private:
+	/**
+	 * The room being generated, and what to spawn in it.
+	 */
+	Level m_level;
+	SpawnPlan m_spawnPlan;
+
+	/**
+	 * The thread generating the room.
+	 */
+	std::thread m_thread;
+
+	/**
+	 * The time the last background generation and the last call to Finish() took in microseconds.
+	 */
+	std::atomic<long long> m_generationTime;
+	long long m_finishTime;
+};
+#endif
\ No newline at end of file
@@ -0,0 +1,107 @@
+//-------------------------------------------------------------------------------------
+// LevelPack.h
+//
+// THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A
+// PARTICULAR PURPOSE.
+//
+// Written by Dale Green. Copyright (c) Packt Publishing. All rights reserved.
+//-------------------------------------------------------------------------------------
+#ifndef LEVELPACK_H
+#define LEVELPACK_H
+
+#include "LevelFile.h"
+
+// The first bytes of every level pack.
+static char const LEVEL_PACK_MAGIC[4] = { 'D', 'P', 'L', 'P' };
+
+// The version of the level pack format. Packs of any other version are rejected.
+static std::uint32_t const LEVEL_PACK_VERSION = 1;
+
+
+/**
+ * The header at the start of a level pack. Every field is little-endian.
+ * It is followed by the index, which has one LevelPackEntry for each level. The levels follow the index, each starting on a multiple of 8 bytes.
+ */
+struct LevelPackHeader
+{
+	char magic[4];						// LEVEL_PACK_MAGIC.
+	std::uint32_t version;				// LEVEL_PACK_VERSION.
+	std::uint32_t levelCount;			// The number of entries in the index.
+	std::uint32_t checksum;				// The FNV-1a hash of the index.
+};
+static_assert(sizeof(LevelPackHeader) == 16, "The level pack header must have no padding.");
+
+/**
+ * An entry in the index of a level pack. The level's ID is the position of its entry.
+ */
+struct LevelPackEntry
+{
+	std::uint64_t offset;				// The position of the level from the start of the pack.
+	std::uint32_t size;					// The size of the level in bytes.
+	std::uint32_t reserved;				// Always 0.
+};
+static_assert(sizeof(LevelPackEntry) == 16, "A level pack entry must have no padding.");
+
+class LevelPack
+{
+public:
+	/**
+	 * Default constructor. The pack is empty until Open() is called.
+	 */
+	LevelPack();
+
+	/**
+	 * Maps a level pack and checks its index. The levels themselves are only checked when they are fetched.
+	 * @param fileName The path to the pack.
+	 * @return True if the file is a valid pack of the current version.
+	 */
+	bool Open(const std::string& fileName);
+
+	/**
+	 * Gets the number of levels in the pack.
+	 * @return The number of levels. Their IDs run from 0 to one below this.
+	 */
+	int GetLevelCount() const;
+
+	/**
+	 * Fetches a level from the pack. It is found through the index, so this takes the same time however many levels the pack holds.
+	 * @param levelID The ID of the level.
+	 * @param level Receives the level, which points into the pack and is valid while the pack is open.
+	 * @return True if the ID is in the pack and the level is valid.
+	 */
+	bool GetLevel(int levelID, LevelFile& level) const;
+
+	/**
+	 * Builds a level pack.
+	 * @param levels The levels to pack, each as built by LevelFile::Serialize(). Their IDs are their positions in the list.
+	 * @param data Receives the pack.
+	 */
+	static void Serialize(const std::vector<std::vector<unsigned char>>& levels, std::vector<unsigned char>& data);
+
+	/**
+	 * Writes a level pack file.
+	 * @param fileName The path to write to.
+	 * @param levels The levels to pack, each as built by LevelFile::Serialize(). Their IDs are their positions in the list.
+	 * @return True if the file was written.
+	 */
+	static bool Write(const std::string& fileName, const std::vector<std::vector<unsigned char>>& levels);
+
+private:
+	/**
+	 * The mapped pack.
+	 */
+	MappedFile m_file;
+
+	/**
+	 * The number of levels in the pack.
+	 */
+	int m_levelCount;
+
+	/**
+	 * The index, which points into the pack.
+	 */
+	const unsigned char* m_index;
+};
+#endif
\ No newline at end of file
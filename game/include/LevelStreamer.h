@@ -0,0 +1,159 @@
+//-------------------------------------------------------------------------------------
+// LevelStreamer.h
+//
+// THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A
+// PARTICULAR PURPOSE.
+//
+// Written by Dale Green. Copyright (c) Packt Publishing. All rights reserved.
+//-------------------------------------------------------------------------------------
+#ifndef LEVELSTREAMER_H
+#define LEVELSTREAMER_H
+
+#include <unordered_map>
+#include "Level.h"
+
+// The width and height of each chunk of an endless floor in tiles. It is even, so the maze cells of neighbouring chunks line up.
+static int const CHUNK_SIZE = 16;
+
+// How many chunks are kept in the level on each side of the chunk the player is in.
+static int const CHUNK_RADIUS = 1;
+
+// The most chunks kept in serialized form once they are out of range.
+// Chunks dropped beyond this are generated again from the seed, losing any changes made to them.
+static int const MAX_STORED_CHUNKS = 256;
+
+// The number of gaps in the walls along the west and north edges of each chunk.
+static int const CHUNK_EDGE_OPENINGS = 2;
+
+// The number of extra walls knocked out of each chunk's maze, so there is more than one way around it.
+static int const CHUNK_EXTRA_OPENINGS = 6;
+
+class LevelStreamer
+{
+public:
+	/**
+	 * Default constructor.
+	 */
+	LevelStreamer();
+
+	/**
+	 * Gets the size of the level that the chunks in range are streamed into, including a ring of wall around them.
+	 * @return The size in tiles.
+	 */
+	static sf::Vector2i GetLevelSize();
+
+	/**
+	 * Gets the position that a run on an endless floor starts from.
+	 * @return A floor tile position in the first chunk.
+	 */
+	static sf::Vector2f GetStartLocation();
+
+	/**
+	 * Forgets every chunk and starts a new endless floor.
+	 * @param seed The seed that every chunk is generated from.
+	 */
+	void Reset(std::uint64_t seed);
+
+	/**
+	 * Streams the chunks around a position into a level, if the position has moved into another chunk.
+	 * Chunks that go out of range are serialized, and chunks that come into range are loaded, or generated if they are new.
+	 * The level's sprites are dropped when it moves, so BindSprites() must be called before it is drawn again.
+	 * @param level The level to stream into. It must be GetLevelSize() in size.
+	 * @param position The position to keep the chunks around, such as the player's.
+	 * @return True if the level was moved.
+	 */
+	bool Update(Level& level, sf::Vector2f position);
+
+	/**
+	 * Gets the number of chunks held in serialized form.
+	 * @return The number of chunks.
+	 */
+	int GetStoredChunkCount() const;
+
+	/**
+	 * Gets the memory used by the serialized chunks.
+	 * @return The size of the serialized data in bytes.
+	 */
+	size_t GetStoredByteCount() const;
+
+private:
+	/**
+	 * Gets the chunk that a position lies in.
+	 * @param position The position to find the chunk of.
+	 * @return The coordinates of the chunk.
+	 */
+	static sf::Vector2i GetChunk(sf::Vector2f position);
+
+	/**
+	 * Gets the key that a chunk is stored under.
+	 * @param chunk The coordinates of the chunk.
+	 * @return A key unique to the chunk.
+	 */
+	static std::uint64_t GetChunkKey(sf::Vector2i chunk);
+
+	/**
+	 * Generates the layout of a chunk from the seed.
+	 * The chunk owns the walls along its west and north edges, and puts gaps in them so it joins up with its neighbours.
+	 * @param chunk The coordinates of the chunk.
+	 * @param tiles Filled with the chunk's tiles, indexed by column * CHUNK_SIZE + row.
+	 */
+	void GenerateChunk(sf::Vector2i chunk, TILE* tiles) const;
+
+	/**
+	 * Serializes a chunk that has gone out of range, dropping the least recently stored chunk if the store is full.
+	 * @param chunk The coordinates of the chunk.
+	 * @param tiles The chunk's tiles, indexed by column * CHUNK_SIZE + row.
+	 */
+	void SaveChunk(sf::Vector2i chunk, const TILE* tiles);
+
+	/**
+	 * Takes a chunk out of the store.
+	 * @param chunk The coordinates of the chunk.
+	 * @param tiles Filled with the chunk's tiles, indexed by column * CHUNK_SIZE + row.
+	 * @return True if the chunk was stored.
+	 */
+	bool LoadChunk(sf::Vector2i chunk, TILE* tiles);
+
+private:
+	/**
+	 * A chunk in serialized form, as runs of tiles of the same type, and when it was stored.
+	 */
+	struct StoredChunk
+	{
+		std::vector<unsigned char> runs;
+		long long storeTime;
+	};
+
+	/**
+	 * The seed that every chunk is generated from.
+	 */
+	std::uint64_t m_seed;
+
+	/**
+	 * Whether the level holds any chunks yet.
+	 */
+	bool m_isStreaming;
+
+	/**
+	 * The chunk in the middle of the level.
+	 */
+	sf::Vector2i m_centerChunk;
+
+	/**
+	 * The chunks that are out of range, by their keys.
+	 */
+	std::unordered_map<std::uint64_t, StoredChunk> m_storedChunks;
+
+	/**
+	 * The number of chunks stored so far, used to find the oldest one.
+	 */
+	long long m_storeCount;
+
+	/**
+	 * The total size of the serialized chunks in bytes.
+	 */
+	size_t m_storedByteCount;
+};
+#endif
\ No newline at end of file
@@ -0,0 +1,72 @@
+//-------------------------------------------------------------------------------------
+// LineOfSight.h
+//
+// THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A
+// PARTICULAR PURPOSE.
+//
+// Written by Dale Green. Copyright (c) Packt Publishing. All rights reserved.
+//-------------------------------------------------------------------------------------
+#ifndef LINEOFSIGHT_H
+#define LINEOFSIGHT_H
+
+#include "Level.h"
+
+class LineOfSight
+{
+public:
+	/**
+	 * Default constructor.
+	 */
+	LineOfSight();
+
+	/**
+	 * Rebuilds the solid tiles of a level if it has changed since the last update.
+	 * Only a new level, or a tile changing between floor and solid, causes a rebuild.
+	 * @param level The level to check lines through.
+	 */
+	void Update(const Level& level);
+
+	/**
+	 * Checks if a square box can move in a straight line between two positions without overlapping a solid tile.
+	 * The box must be smaller than a tile.
+	 * @param start The center of the box at the start of the move.
+	 * @param end The center of the box at the end of the move.
+	 * @param halfSize Half the width of the box.
+	 * @return True if nothing is in the way.
+	 */
+	bool IsClear(sf::Vector2f start, sf::Vector2f end, float halfSize) const;
+
+private:
+	/**
+	 * Walks the tiles that a line passes through, in order, until it reaches one that is solid.
+	 * @param start The start of the line, measured in tiles from the level origin.
+	 * @param end The end of the line, measured in tiles from the level origin.
+	 * @return True if none of the tiles are solid.
+	 */
+	bool IsRayClear(sf::Vector2f start, sf::Vector2f end) const;
+
+	/**
+	 * Checks if a tile blocks movement. Tiles outside the level always do.
+	 * @param columnIndex The column that the tile is in.
+	 * @param rowIndex The row that the tile is in.
+	 * @return True if the tile is not floor.
+	 */
+	bool IsSolid(int columnIndex, int rowIndex) const;
+
+private:
+	/**
+	 * The tiles that can be walked through, copied from the level.
+	 */
+	TileBitboard m_walkableTiles;
+
+	/**
+	 * The level the tiles were read from, its size and position, and its walkability revision at the time.
+	 */
+	const Level* m_level;
+	sf::Vector2i m_size;
+	sf::Vector2f m_origin;
+	unsigned int m_revision;
+};
+#endif
\ No newline at end of file
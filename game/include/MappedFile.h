@@ -0,0 +1,71 @@
+//-------------------------------------------------------------------------------------
+// MappedFile.h
+//
+// THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A
+// PARTICULAR PURPOSE.
+//
+// Written by Dale Green. Copyright (c) Packt Publishing. All rights reserved.
+//-------------------------------------------------------------------------------------
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <string>
+
+class MappedFile
+{
+public:
+	/**
+	 * Default constructor. Nothing is mapped until Open() is called.
+	 */
+	MappedFile();
+
+	/**
+	 * Destructor. Unmaps the file.
+	 */
+	~MappedFile();
+
+	/**
+	 * A mapping can't be shared, so it can't be copied.
+	 */
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	/**
+	 * Maps a whole file into memory, read only. The operating system pages it in as it is read, so nothing is copied up front.
+	 * Any file that was already mapped is unmapped first.
+	 * @param fileName The path to the file.
+	 * @return True if the file was mapped. Empty files can't be mapped.
+	 */
+	bool Open(const std::string& fileName);
+
+	/**
+	 * Unmaps the file. Pointers into it are no longer valid afterwards.
+	 */
+	void Close();
+
+	/**
+	 * Gets the contents of the file.
+	 * @return A pointer to the first byte, or nullptr if nothing is mapped.
+	 */
+	const unsigned char* GetData() const;
+
+	/**
+	 * Gets the size of the file.
+	 * @return The number of bytes mapped.
+	 */
+	size_t GetSize() const;
+
+private:
+	/**
+	 * The start of the mapping.
+	 */
+	const unsigned char* m_data;
+
+	/**
+	 * The size of the mapping in bytes.
+	 */
+	size_t m_size;
+};
+#endif
\ No newline at end of file
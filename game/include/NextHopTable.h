@@ -0,0 +1,140 @@
+//-------------------------------------------------------------------------------------
+// NextHopTable.h
+//
+// THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A
+// PARTICULAR PURPOSE.
+//
+// Written by Dale Green. Copyright (c) Packt Publishing. All rights reserved.
+//-------------------------------------------------------------------------------------
+#ifndef NEXTHOPTABLE_H
+#define NEXTHOPTABLE_H
+
+#include <atomic>
+#include <thread>
+#include "Level.h"
+
+// The largest number of tiles a level can have for the table to be built. The table takes one byte per pair of tiles.
+static int const NEXT_HOP_TABLE_MAX_NODE_COUNT = 1024;
+
+
+class NextHopTable
+{
+public:
+	/**
+	 * Default constructor.
+	 */
+	NextHopTable();
+
+	/**
+	 * Destructor.
+	 * Waits for a background build to finish.
+	 */
+	~NextHopTable();
+
+	/**
+	 * Builds the table for a level on the calling thread.
+	 * Does nothing if the level has more than NEXT_HOP_TABLE_MAX_NODE_COUNT tiles.
+	 * @param level The level to build the table for.
+	 */
+	void Build(const Level& level);
+
+	/**
+	 * Starts building the table for a level on a background thread, replacing any build that is already running.
+	 * The level is copied first, so it can change while the table builds. The old table is kept until the new one is ready.
+	 * Does nothing if the level has more than NEXT_HOP_TABLE_MAX_NODE_COUNT tiles.
+	 * @param level The level to build the table for.
+	 */
+	void BuildInBackground(const Level& level);
+
+	/**
+	 * Checks if the table can be used for a level. Picks up the result of a background build if it has finished.
+	 * @param level The level to check against.
+	 * @return True if the table was built for the level and no tile has changed between floor and solid since.
+	 */
+	bool IsReady(const Level& level);
+
+	/**
+	 * Checks if a background build is running.
+	 * @return True if a build has been started and its result hasn't been picked up yet.
+	 */
+	bool IsBuilding() const;
+
+	/**
+	 * Reads the shortest path between two tiles from the table. The table must be ready for the level.
+	 * @param level The level that the table was built for.
+	 * @param startNode The tile to start from.
+	 * @param goalNode The tile to find a path to.
+	 * @param path Filled with the positions of the tiles on the path, excluding the start tile. Empty if there is no path.
+	 * @return True if a path was found.
+	 */
+	bool FindPath(const Level& level, const Tile* startNode, const Tile* goalNode, std::vector<sf::Vector2f>& path) const;
+
+	/**
+	 * Gets the memory used by the table.
+	 * @return The size of the table in bytes.
+	 */
+	size_t GetMemoryUsage() const;
+
+	/**
+	 * Gets the time the last finished build took.
+	 * @return The build time in microseconds.
+	 */
+	long long GetBuildTime() const;
+
+private:
+	/**
+	 * Fills a table with the first step of the shortest path between every pair of tiles.
+	 * @param size The size of the level.
+	 * @param walkable Whether each tile can be walked on, indexed by column * height + row.
+	 * @param nextHops Filled with the direction of the first step from each start to each goal, indexed by goal * tile count + start.
+	 * @param cancel Set to stop the build early.
+	 */
+	static void Fill(sf::Vector2i size, const std::vector<bool>& walkable, std::vector<unsigned char>& nextHops, const std::atomic<bool>& cancel);
+
+	/**
+	 * Waits for a background build to finish, and replaces the table with its result unless it was cancelled.
+	 */
+	void FinishBuild();
+
+private:
+	/**
+	 * The direction of the first step of the shortest path from each tile to each other tile.
+	 */
+	std::vector<unsigned char> m_nextHops;
+
+	/**
+	 * The level the table was built for, its size, and its walkability revision at the time.
+	 */
+	const Level* m_level;
+	sf::Vector2i m_size;
+	unsigned int m_revision;
+
+	/**
+	 * The time the last finished build took in microseconds.
+	 */
+	long long m_buildTime;
+
+	/**
+	 * The thread running a background build, and the data it builds from and into.
+	 */
+	std::thread m_buildThread;
+	std::vector<bool> m_buildWalkable;
+	std::vector<unsigned char> m_buildNextHops;
+	const Level* m_buildLevel;
+	sf::Vector2i m_buildSize;
+	unsigned int m_buildRevision;
+	long long m_buildThreadTime;
+
+	/**
+	 * Set by the background thread when its build has finished.
+	 */
+	std::atomic<bool> m_isBuildFinished;
+
+	/**
+	 * Set to stop a background build early.
+	 */
+	std::atomic<bool> m_cancelBuild;
+};
+#endif
\ No newline at end of file
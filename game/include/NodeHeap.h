@@ -0,0 +1,143 @@
+//-------------------------------------------------------------------------------------
+// NodeHeap.h
+//
+// THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A
+// PARTICULAR PURPOSE.
+//
+// Written by Dale Green. Copyright (c) Packt Publishing. All rights reserved.
+//-------------------------------------------------------------------------------------
+#ifndef NODEHEAP_H
+#define NODEHEAP_H
+
+#include <vector>
+
+class NodeHeap
+{
+public:
+	/**
+	 * Default constructor.
+	 */
+	NodeHeap();
+
+	/**
+	 * Prepares the heap to hold nodes with indices in the range [0, nodeCount).
+	 * @param nodeCount The number of nodes that can be stored in the heap.
+	 */
+	void Resize(int nodeCount);
+
+	/**
+	 * Removes all nodes from the heap. Only touches the nodes that are currently stored.
+	 */
+	void Clear();
+
+	/**
+	 * Checks if the heap contains any nodes.
+	 * @return True if the heap is empty.
+	 */
+	bool IsEmpty() const;
+
+	/**
+	 * Checks if the given node is stored in the heap.
+	 * @param node The index of the node to check.
+	 * @return True if the node is in the heap.
+	 */
+	bool Contains(int node) const;
+
+	/**
+	 * Adds a node to the heap.
+	 * Nodes with equal keys are popped in the order that they were pushed.
+	 * @param node The index of the node to add.
+	 * @param key The priority of the node. Lower keys are popped first.
+	 */
+	void Push(int node, long long key);
+
+	/**
+	 * Removes the node with the lowest key from the heap.
+	 * @return The index of the removed node.
+	 */
+	int Pop();
+
+	/**
+	 * Lowers the key of a node that is already in the heap.
+	 * The node keeps its original insertion order for breaking ties.
+	 * @param node The index of the node to update.
+	 * @param key The new, lower, key of the node.
+	 */
+	void DecreaseKey(int node, long long key);
+
+	/**
+	 * Changes the key of a node that is already in the heap, in either direction.
+	 * The node keeps its original insertion order for breaking ties.
+	 * @param node The index of the node to update.
+	 * @param key The new key of the node.
+	 */
+	void UpdateKey(int node, long long key);
+
+	/**
+	 * Removes a node from the heap, wherever it is.
+	 * @param node The index of the node to remove. It must be in the heap.
+	 */
+	void Remove(int node);
+
+	/**
+	 * Gets the lowest key in the heap.
+	 * @return The key of the node that would be popped next. The heap must not be empty.
+	 */
+	long long GetTopKey() const;
+
+	/**
+	 * Gets the node with the lowest key without removing it.
+	 * @return The index of the node that would be popped next. The heap must not be empty.
+	 */
+	int GetTop() const;
+
+private:
+	/**
+	 * A single heap entry.
+	 */
+	struct Entry
+	{
+		long long key;						// The priority of the node.
+		unsigned int order;					// The insertion order, used to break ties.
+		int node;							// The index of the node.
+	};
+
+	/**
+	 * Checks if the entry at index a should be popped before the entry at index b.
+	 */
+	bool IsHigherPriority(size_t a, size_t b) const;
+
+	/**
+	 * Swaps two entries and updates their stored positions.
+	 */
+	void SwapEntries(size_t a, size_t b);
+
+	/**
+	 * Moves the entry at the given index up until the heap property holds.
+	 */
+	void SiftUp(size_t index);
+
+	/**
+	 * Moves the entry at the given index down until the heap property holds.
+	 */
+	void SiftDown(size_t index);
+
+private:
+	/**
+	 * The entries of the binary heap.
+	 */
+	std::vector<Entry> m_entries;
+
+	/**
+	 * The position of each node in the entries vector, or -1 if it is not in the heap.
+	 */
+	std::vector<int> m_positions;
+
+	/**
+	 * The number of pushes since the heap was last cleared.
+	 */
+	unsigned int m_pushCount;
+};
+#endif
\ No newline at end of file
@@ -0,0 +1,137 @@
+//-------------------------------------------------------------------------------------
+// PathCache.h
+//
+// THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A
+// PARTICULAR PURPOSE.
+//
+// Written by Dale Green. Copyright (c) Packt Publishing. All rights reserved.
+//-------------------------------------------------------------------------------------
+#ifndef PATHCACHE_H
+#define PATHCACHE_H
+
+#include <list>
+#include <unordered_map>
+#include "Level.h"
+
+// The default number of paths kept by a path cache.
+static int const PATH_CACHE_CAPACITY = 64;
+
+
+class PathCache
+{
+public:
+	/**
+	 * Constructor.
+	 * @param capacity The number of paths to keep. The least recently used path is dropped to make room for a new one.
+	 */
+	PathCache(int capacity = PATH_CACHE_CAPACITY);
+
+	/**
+	 * Looks up the path between two tiles.
+	 * The cache is emptied first if any tile has changed between floor and solid since the paths were stored,
+	 * or if the paths were stored for a different level.
+	 * @param level The level that the path runs through.
+	 * @param startNode The tile that the path starts from.
+	 * @param goalNode The tile that the path leads to.
+	 * @param path Receives the stored path, excluding the start tile. Empty if the stored search found no path.
+	 * @return True if the path was in the cache.
+	 */
+	bool Find(const Level& level, const Tile* startNode, const Tile* goalNode, std::vector<sf::Vector2f>& path);
+
+	/**
+	 * Stores the path between two tiles, replacing the least recently used path if the cache is full.
+	 * @param level The level that the path runs through.
+	 * @param startNode The tile that the path starts from.
+	 * @param goalNode The tile that the path leads to.
+	 * @param path The path, excluding the start tile. Failed searches are stored as an empty path, so they aren't repeated.
+	 */
+	void Store(const Level& level, const Tile* startNode, const Tile* goalNode, const std::vector<sf::Vector2f>& path);
+
+	/**
+	 * Removes all paths from the cache.
+	 */
+	void Clear();
+
+	/**
+	 * Gets the number of lookups that found a stored path.
+	 * @return The number of cache hits.
+	 */
+	int GetHitCount() const;
+
+	/**
+	 * Gets the number of lookups that didn't find a stored path.
+	 * @return The number of cache misses.
+	 */
+	int GetMissCount() const;
+
+	/**
+	 * Sets the hit and miss counters back to 0.
+	 */
+	void ResetCounters();
+
+	/**
+	 * Gets the number of paths in the cache.
+	 * @return The number of stored paths.
+	 */
+	int GetSize() const;
+
+private:
+	/**
+	 * A stored path.
+	 */
+	struct Entry {
+		long long key;						// The start and goal tiles that the path is for.
+		std::vector<sf::Vector2f> path;		// The path, excluding the start tile.
+	};
+
+	/**
+	 * Calculates the key of the path between two tiles.
+	 * @return A key that is unique to the pair of tiles.
+	 */
+	static long long GetKey(const Level& level, const Tile* startNode, const Tile* goalNode);
+
+	/**
+	 * Empties the cache if the paths were stored for a different level, or the walkable tiles have changed since.
+	 * @param level The level that the paths run through.
+	 */
+	void CheckLevel(const Level& level);
+
+private:
+	/**
+	 * The number of paths to keep.
+	 */
+	int m_capacity;
+
+	/**
+	 * The stored paths, from most to least recently used.
+	 */
+	std::list<Entry> m_entries;
+
+	/**
+	 * The position of each stored path in the list, by key.
+	 */
+	std::unordered_map<long long, std::list<Entry>::iterator> m_index;
+
+	/**
+	 * The level that the paths were stored for.
+	 */
+	const Level* m_level;
+
+	/**
+	 * The walkability revision of the level that the paths were stored for.
+	 */
+	unsigned int m_revision;
+
+	/**
+	 * The number of lookups that found a stored path.
+	 */
+	int m_hitCount;
+
+	/**
+	 * The number of lookups that didn't find a stored path.
+	 */
+	int m_missCount;
+};
+#endif
\ No newline at end of file
@@ -0,0 +1,183 @@
+//-------------------------------------------------------------------------------------
+// PathfindingBatch.h
+//
+// THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A
+// PARTICULAR PURPOSE.
+//
+// Written by Dale Green. Copyright (c) Packt Publishing. All rights reserved.
+//-------------------------------------------------------------------------------------
+#ifndef PATHFINDINGBATCH_H
+#define PATHFINDINGBATCH_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include "PathfindingContext.h"
+#include "PathCache.h"
+
+class PathfindingBatch
+{
+public:
+	/**
+	 * Constructor.
+	 * Starts the worker threads, which wait until a batch is run.
+	 * @param threadCount The number of threads that run searches, including the one that calls Run(). 0 uses one per hardware thread.
+	 */
+	PathfindingBatch(int threadCount = 0);
+
+	/**
+	 * Destructor.
+	 * Stops the worker threads.
+	 */
+	~PathfindingBatch();
+
+	/**
+	 * Removes all requests from the batch.
+	 */
+	void Clear();
+
+	/**
+	 * Adds a search to the batch.
+	 * @param startNode The tile to start from.
+	 * @param goalNode The tile to find a path to.
+	 * @return The index of the request, used to get its result after the batch has run.
+	 */
+	int Add(const Tile* startNode, const Tile* goalNode);
+
+	/**
+	 * Runs all requests in the batch across the worker threads and waits for them to finish.
+	 * The results only depend on the requests, not on the number of threads or the order the searches finish in.
+	 * @param level The level to search. It must not change while the batch runs.
+	 * @param mode The search to use, either A_STAR, JUMP_POINT_SEARCH or HIERARCHICAL.
+	 * @param hierarchy The abstract graph of the level, needed for HIERARCHICAL searches. It must be up to date with the level.
+	 * @param cache The paths found by earlier searches, or nullptr. It is only used by the calling thread.
+	 */
+	void Run(const Level& level, PATHFINDING_MODE mode, const PathfindingHierarchy* hierarchy, PathCache* cache);
+
+	/**
+	 * Gets the path found for a request.
+	 * @param request The index of the request.
+	 * @return The positions of the tiles on the path, excluding the start tile. Empty if there is no path.
+	 */
+	const std::vector<sf::Vector2f>& GetPath(int request) const;
+
+	/**
+	 * Gets the number of nodes expanded for a request.
+	 * @param request The index of the request.
+	 * @return The number of nodes expanded, or 0 if the path came from the cache or an identical request.
+	 */
+	int GetExpandedNodeCount(int request) const;
+
+	/**
+	 * Gets the number of requests in the batch.
+	 * @return The number of requests.
+	 */
+	int GetRequestCount() const;
+
+	/**
+	 * Gets the number of threads that run searches.
+	 * @return The number of threads, including the one that calls Run().
+	 */
+	int GetThreadCount() const;
+
+private:
+	/**
+	 * The loop run by each worker thread. It waits for a batch, helps run its searches, then waits again.
+	 * @param workerIndex The index of the worker's search context.
+	 */
+	void WorkerLoop(int workerIndex);
+
+	/**
+	 * Takes searches from the batch and runs them until there are none left.
+	 * @param workerIndex The index of the search context to use.
+	 */
+	void RunSearches(int workerIndex);
+
+private:
+	/**
+	 * The worker threads. The thread that calls Run() also runs searches, so there is one fewer than the thread count.
+	 */
+	std::vector<std::thread> m_threads;
+
+	/**
+	 * The search context of each thread. The calling thread uses the first one.
+	 */
+	std::vector<PathfindingContext> m_contexts;
+
+	/**
+	 * Guards the batch number, busy worker count and stop flag.
+	 */
+	std::mutex m_mutex;
+
+	/**
+	 * Wakes the workers when a batch is ready, or when they need to stop.
+	 */
+	std::condition_variable m_batchReady;
+
+	/**
+	 * Wakes the calling thread when the last worker finishes a batch.
+	 */
+	std::condition_variable m_batchFinished;
+
+	/**
+	 * Increases each time a batch is handed to the workers.
+	 */
+	unsigned int m_batchNumber;
+
+	/**
+	 * The number of workers still running searches from the current batch.
+	 */
+	int m_busyWorkerCount;
+
+	/**
+	 * Whether the workers should stop.
+	 */
+	bool m_isStopping;
+
+	/**
+	 * The index of the next search to be taken by a thread.
+	 */
+	std::atomic<int> m_nextSearch;
+
+	/**
+	 * The level, search mode and hierarchy of the batch that is running.
+	 */
+	const Level* m_level;
+	PATHFINDING_MODE m_mode;
+	const PathfindingHierarchy* m_hierarchy;
+
+	/**
+	 * The start and goal tiles of each request.
+	 */
+	std::vector<std::pair<const Tile*, const Tile*>> m_requests;
+
+	/**
+	 * The path found for each request. The vectors are kept between batches to reuse their memory.
+	 */
+	std::vector<std::vector<sf::Vector2f>> m_paths;
+
+	/**
+	 * The number of nodes expanded for each request.
+	 */
+	std::vector<int> m_expandedNodeCounts;
+
+	/**
+	 * The requests that need a search, after cached and repeated requests have been removed.
+	 */
+	std::vector<int> m_searches;
+
+	/**
+	 * The request that each repeated request takes its path from, or -1.
+	 */
+	std::vector<int> m_sources;
+
+	/**
+	 * The first request for each start and goal pair in the batch.
+	 */
+	std::unordered_map<long long, int> m_firstRequests;
+};
+#endif
\ No newline at end of file
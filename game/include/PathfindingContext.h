@@ -0,0 +1,268 @@
+//-------------------------------------------------------------------------------------
+// PathfindingContext.h
+//
+// THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A
+// PARTICULAR PURPOSE.
+//
+// Written by Dale Green. Copyright (c) Packt Publishing. All rights reserved.
+//-------------------------------------------------------------------------------------
+#ifndef PATHFINDINGCONTEXT_H
+#define PATHFINDINGCONTEXT_H
+
+#include "Level.h"
+#include "NodeHeap.h"
+#include "PathfindingHierarchy.h"
+
+// The movement cost of a single step between two tiles.
+static int const PATHFINDING_STEP_COST = 10;
+
+// The movement cost of a diagonal step in jump point search, which uses octile distances.
+static int const PATHFINDING_DIAGONAL_STEP_COST = 14;
+
+
+class PathfindingContext
+{
+public:
+	/**
+	 * Default constructor.
+	 */
+	PathfindingContext();
+
+	/**
+	 * Finds a path between two tiles with A*.
+	 * The level is only read, so different contexts can search the same level at the same time.
+	 * @param level The level to search.
+	 * @param startNode The tile to start from.
+	 * @param goalNode The tile to find a path to.
+	 * @param path Receives the positions of the tiles on the path, excluding the start tile. Empty if there is no path.
+	 * @return True if a path was found.
+	 */
+	bool FindPath(const Level& level, const Tile* startNode, const Tile* goalNode, std::vector<sf::Vector2f>& path);
+
+	/**
+	 * Finds a path between two tiles with A*, without leaving the given area.
+	 * @param level The level to search.
+	 * @param startNode The tile to start from.
+	 * @param goalNode The tile to find a path to.
+	 * @param bounds The column, row, width and height of the area that the path must stay inside.
+	 * @param path Receives the positions of the tiles on the path, excluding the start tile. Empty if there is no path.
+	 * @return True if a path was found.
+	 */
+	bool FindPath(const Level& level, const Tile* startNode, const Tile* goalNode, const sf::IntRect& bounds, std::vector<sf::Vector2f>& path);
+
+	/**
+	 * Starts an A* search that can be run a few nodes at a time with ContinuePath().
+	 * The search state lives in the context, so the context can't be used for other searches until this one ends.
+	 * @param level The level to search.
+	 * @param startNode The tile to start from.
+	 * @param goalNode The tile to find a path to.
+	 * @param bounds The column, row, width and height of the area that the path must stay inside.
+	 */
+	void BeginPath(const Level& level, const Tile* startNode, const Tile* goalNode, const sf::IntRect& bounds);
+
+	/**
+	 * Continues the A* search started by BeginPath(). Running a search in steps finds the same path as FindPath().
+	 * @param level The level to search. Its walkable tiles must not change during the search.
+	 * @param maxExpandedNodeCount The number of nodes to expand before pausing the search.
+	 * @param path Receives the positions of the tiles on the path, excluding the start tile, once one is found.
+	 * @return IN_PROGRESS if the search paused, otherwise whether it found a path.
+	 */
+	PATHFINDING_STATUS ContinuePath(const Level& level, int maxExpandedNodeCount, std::vector<sf::Vector2f>& path);
+
+	/**
+	 * Finds a path between two tiles with jump point search.
+	 * Straight and diagonal runs through open space are skipped over rather than expanded tile by tile.
+	 * Diagonal steps cost more than straight ones, so paths prefer straight lines and can differ from FindPath().
+	 * @param level The level to search.
+	 * @param startNode The tile to start from.
+	 * @param goalNode The tile to find a path to.
+	 * @param path Receives the positions of every tile on the path, excluding the start tile. Empty if there is no path.
+	 * @return True if a path was found.
+	 */
+	bool FindJumpPointPath(const Level& level, const Tile* startNode, const Tile* goalNode, std::vector<sf::Vector2f>& path);
+
+	/**
+	 * Finds a path between two tiles through the abstract graph of a pathfinding hierarchy.
+	 * The search runs between cluster entrances, then each step is refined into tiles inside its cluster.
+	 * Paths are close to, but not always as short as, the ones found by FindPath().
+	 * @param level The level to search.
+	 * @param hierarchy The abstract graph of the level. It must be up to date with the level.
+	 * @param startNode The tile to start from.
+	 * @param goalNode The tile to find a path to.
+	 * @param path Receives the positions of the tiles on the path, excluding the start tile. Empty if there is no path.
+	 * @return True if a path was found.
+	 */
+	bool FindHierarchicalPath(const Level& level, const PathfindingHierarchy& hierarchy, const Tile* startNode, const Tile* goalNode, std::vector<sf::Vector2f>& path);
+
+	/**
+	 * Gets the number of nodes that the last search expanded.
+	 * For hierarchical searches this includes the abstract search and every refinement.
+	 * @return The number of nodes moved to the closed list by the last search.
+	 */
+	int GetExpandedNodeCount() const;
+
+	/**
+	 * Gets the number of tiles that the last jump point search stepped over while jumping.
+	 * @return The number of tiles scanned by the last jump point search.
+	 */
+	int GetScannedNodeCount() const;
+
+private:
+	/**
+	 * Prepares the scratch arrays for a new search. Stale node data is invalidated by
+	 * advancing the generation, so the arrays are only cleared when they are resized.
+	 * @param nodeCount The number of tiles in the level being searched.
+	 */
+	void BeginSearch(int nodeCount);
+
+	/**
+	 * Checks if the given node has been reached by the current search.
+	 * @param node The index of the node.
+	 * @return True if the node data is valid for the current search.
+	 */
+	bool IsVisited(int node) const;
+
+	/**
+	 * Marks a node as reached by the current search and initializes its data.
+	 * @param node The index of the node.
+	 * @param parent The index of the node's parent, or -1 for the start node.
+	 * @param G The movement cost to reach the node.
+	 * @param F The estimated cost of the full path through the node.
+	 */
+	void Visit(int node, int parent, int G, int F);
+
+	/**
+	 * Checks if a tile can be walked on. Tiles outside of the level can't.
+	 * @param level The level being searched.
+	 * @param columnIndex The column that the tile is in.
+	 * @param rowIndex The row that the tile is in.
+	 * @return True if the tile is a floor tile.
+	 */
+	bool IsWalkable(const Level& level, int columnIndex, int rowIndex) const;
+
+	/**
+	 * Calculates the cost of reaching every tile in an area from a tile.
+	 * The results are left in m_G, for the tiles that IsVisited() returns true for.
+	 * @param level The level being searched.
+	 * @param startNode The tile to start from.
+	 * @param bounds The column, row, width and height of the area to search.
+	 */
+	void FindCosts(const Level& level, const Tile* startNode, const sf::IntRect& bounds);
+
+	/**
+	 * Reaches a node of the abstract graph through an edge, adding it to the open list or re-parenting it.
+	 * @param node The index of the node that the edge leaves from.
+	 * @param edge The edge to follow.
+	 * @param goalNode The goal of the search.
+	 * @param levelHeight The number of rows in the level.
+	 */
+	void RelaxEdge(int node, const PathfindingEdge& edge, const Tile* goalNode, int levelHeight);
+
+	/**
+	 * Checks if a tile lies inside an area.
+	 * @return True if the tile is inside the area.
+	 */
+	static bool IsInside(const sf::IntRect& bounds, int columnIndex, int rowIndex);
+
+	/**
+	 * Moves from a tile in the given direction until a jump point is found.
+	 * @param level The level being searched.
+	 * @param columnIndex The column of the tile to jump from.
+	 * @param rowIndex The row of the tile to jump from.
+	 * @param dx The column direction of the jump.
+	 * @param dy The row direction of the jump.
+	 * @param goalNode The goal of the search, which is always a jump point.
+	 * @return The index of the jump point, or -1 if the jump hit a wall.
+	 */
+	int Jump(const Level& level, int columnIndex, int rowIndex, int dx, int dy, const Tile* goalNode);
+
+	/**
+	 * Calculates the octile distance between two tiles.
+	 * @return The cost of moving between the tiles in open space.
+	 */
+	static int OctileDistance(int columnA, int rowA, int columnB, int rowB);
+
+private:
+	/**
+	 * The search generation that each node was last written in.
+	 */
+	std::vector<unsigned int> m_generations;
+
+	/**
+	 * The index of the node used to reach each node.
+	 */
+	std::vector<int> m_parents;
+
+	/**
+	 * The movement cost to reach each node. (Total of entire path)
+	 */
+	std::vector<int> m_G;
+
+	/**
+	 * The estimated cost of the full path through each node. (G + H)
+	 */
+	std::vector<int> m_F;
+
+	/**
+	 * Whether each node has been moved to the closed list.
+	 */
+	std::vector<bool> m_closed;
+
+	/**
+	 * The open list, ordered by F.
+	 */
+	NodeHeap m_openList;
+
+	/**
+	 * The queue of tiles used when calculating costs in an area.
+	 */
+	std::vector<int> m_queue;
+
+	/**
+	 * The costs from the start of a hierarchical search to the entrances of its cluster.
+	 */
+	std::vector<PathfindingEdge> m_startEdges;
+
+	/**
+	 * The costs from the entrances of the goal cluster to the goal of a hierarchical search.
+	 */
+	std::vector<PathfindingEdge> m_goalEdges;
+
+	/**
+	 * The tiles on the abstract path of a hierarchical search, from start to goal.
+	 */
+	std::vector<int> m_abstractPath;
+
+	/**
+	 * The refined path of one step of a hierarchical search.
+	 */
+	std::vector<sf::Vector2f> m_segment;
+
+	/**
+	 * The goal of the A* search in progress.
+	 */
+	const Tile* m_goalNode;
+
+	/**
+	 * The area that the A* search in progress must stay inside.
+	 */
+	sf::IntRect m_bounds;
+
+	/**
+	 * The generation of the current search.
+	 */
+	unsigned int m_generation;
+
+	/**
+	 * The number of nodes that the last search expanded.
+	 */
+	int m_expandedNodeCount;
+
+	/**
+	 * The number of tiles that the last jump point search stepped over.
+	 */
+	int m_scannedNodeCount;
+};
+#endif
\ No newline at end of file
@@ -0,0 +1,155 @@
+//-------------------------------------------------------------------------------------
+// PathfindingHierarchy.h
+//
+// THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A
+// PARTICULAR PURPOSE.
+//
+// Written by Dale Green. Copyright (c) Packt Publishing. All rights reserved.
+//-------------------------------------------------------------------------------------
+#ifndef PATHFINDINGHIERARCHY_H
+#define PATHFINDINGHIERARCHY_H
+
+#include "Level.h"
+
+// The width and height of each pathfinding cluster in tiles.
+static int const PATHFINDING_CLUSTER_SIZE = 10;
+
+
+// An edge in the abstract pathfinding graph.
+struct PathfindingEdge {
+	int node;							// The index of the tile that the edge leads to.
+	int cost;							// The movement cost of the edge.
+};
+
+class PathfindingHierarchy
+{
+public:
+	/**
+	 * Default constructor.
+	 */
+	PathfindingHierarchy();
+
+	/**
+	 * Brings the abstract graph up to date with the level.
+	 * Only the clusters around tiles whose walkability changed are rebuilt, unless the whole level has been replaced.
+	 * @param level The level to build the graph for.
+	 * @return The number of clusters that were rebuilt.
+	 */
+	int Update(const Level& level);
+
+	/**
+	 * Gets the cluster that a tile belongs to.
+	 * @param columnIndex The column that the tile is in.
+	 * @param rowIndex The row that the tile is in.
+	 * @return The index of the cluster.
+	 */
+	int GetClusterIndex(int columnIndex, int rowIndex) const;
+
+	/**
+	 * Gets the tiles covered by a cluster.
+	 * @param clusterIndex The index of the cluster.
+	 * @return The column, row, width and height of the cluster in tiles.
+	 */
+	sf::IntRect GetClusterBounds(int clusterIndex) const;
+
+	/**
+	 * Gets the entrance tiles of a cluster. Each entrance has an edge to a tile in a neighbouring cluster.
+	 * @param clusterIndex The index of the cluster.
+	 * @return The indices of the entrance tiles.
+	 */
+	const std::vector<int>& GetEntrances(int clusterIndex) const;
+
+	/**
+	 * Gets the edges leaving a tile in the abstract graph.
+	 * @param node The index of the tile.
+	 * @return The edges to the other entrances of the tile's cluster and across its border. Empty if the tile is not an entrance.
+	 */
+	const std::vector<PathfindingEdge>& GetEdges(int node) const;
+
+	/**
+	 * Gets the number of entrance tiles in the abstract graph.
+	 * @return The number of entrance tiles in all clusters.
+	 */
+	int GetEntranceCount() const;
+
+private:
+	/**
+	 * Rebuilds the whole graph for the level.
+	 * @param level The level to build the graph for.
+	 */
+	void Build(const Level& level);
+
+	/**
+	 * Rebuilds the entrances and edges of one cluster.
+	 * @param clusterIndex The index of the cluster.
+	 */
+	void BuildCluster(int clusterIndex);
+
+	/**
+	 * Finds the places where a path can cross from one cluster into a neighbouring one.
+	 * Every crossing tile is connected to one of the crossings found, so no paths are lost.
+	 * @param clusterIndex The index of the cluster.
+	 * @param neighbourIndex The index of the neighbouring cluster, which can be diagonal.
+	 * @param crossings Receives pairs of tiles, the first in the cluster and the second in the neighbour.
+	 */
+	void FindCrossings(int clusterIndex, int neighbourIndex, std::vector<std::pair<int, int>>& crossings) const;
+
+	/**
+	 * Checks if a tile could be walked on when the graph was built. Tiles outside of the level can't.
+	 * @param columnIndex The column that the tile is in.
+	 * @param rowIndex The row that the tile is in.
+	 * @return True if the tile is a floor tile.
+	 */
+	bool IsWalkable(int columnIndex, int rowIndex) const;
+
+private:
+	/**
+	 * The size of the level that the graph was built for.
+	 */
+	sf::Vector2i m_size;
+
+	/**
+	 * The number of clusters across and down the level.
+	 */
+	sf::Vector2i m_clusterCount;
+
+	/**
+	 * The layout revision of the level that the graph was built for.
+	 */
+	unsigned int m_revision;
+
+	/**
+	 * Whether each tile could be walked on when the graph was built, indexed by column * height + row.
+	 */
+	std::vector<bool> m_walkable;
+
+	/**
+	 * The entrance tiles of each cluster.
+	 */
+	std::vector<std::vector<int>> m_entrances;
+
+	/**
+	 * The edges leaving each tile. Only entrance tiles have any.
+	 */
+	std::vector<std::vector<PathfindingEdge>> m_edges;
+
+	/**
+	 * The tiles that changed since the graph was last updated.
+	 */
+	std::vector<sf::Vector2i> m_changedTiles;
+
+	/**
+	 * The clusters that need rebuilding after a change.
+	 */
+	std::vector<int> m_dirtyClusters;
+
+	/**
+	 * Scratch data used while building clusters.
+	 */
+	std::vector<std::pair<int, int>> m_crossings;
+	std::vector<int> m_distances;
+	std::vector<int> m_openList;
+};
+#endif
\ No newline at end of file
@@ -0,0 +1,155 @@
+//-------------------------------------------------------------------------------------
+// PathfindingPlanner.h
+//
+// THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A
+// PARTICULAR PURPOSE.
+//
+// Written by Dale Green. Copyright (c) Packt Publishing. All rights reserved.
+//-------------------------------------------------------------------------------------
+#ifndef PATHFINDINGPLANNER_H
+#define PATHFINDINGPLANNER_H
+
+#include "Level.h"
+#include "NodeHeap.h"
+
+class PathfindingPlanner
+{
+public:
+	/**
+	 * Default constructor.
+	 */
+	PathfindingPlanner();
+
+	/**
+	 * Finds a path between two tiles with D* Lite, repairing the previous search instead of starting again where it can.
+	 * The search grows out from the goal, so the start can move anywhere and the goal can move by one tile between searches.
+	 * Tiles that have changed between floor and solid since the last search only update the nodes that depended on them.
+	 * A new level, a goal that moved further, or too many tile changes start a full search.
+	 * @param level The level to find a path through.
+	 * @param startNode The tile to start from.
+	 * @param goalNode The tile to find a path to.
+	 * @param path Filled with the positions of the tiles on the path, excluding the start tile. Empty if there is no path.
+	 * @return True if a path was found.
+	 */
+	bool FindPath(const Level& level, const Tile* startNode, const Tile* goalNode, std::vector<sf::Vector2f>& path);
+
+	/**
+	 * Makes the next search a full one.
+	 */
+	void Reset();
+
+	/**
+	 * Checks if the last search repaired the one before it.
+	 * @return True if the last search was a repair, false if it started from scratch.
+	 */
+	bool IsRepair() const;
+
+	/**
+	 * Gets the number of nodes that the last search expanded.
+	 * @return The number of nodes taken off the open list by the last search.
+	 */
+	int GetExpandedNodeCount() const;
+
+	/**
+	 * Gets the number of nodes that the last search touched.
+	 * @return The number of times the last search recalculated the cost of a node from its neighbors.
+	 */
+	int GetTouchedNodeCount() const;
+
+private:
+	/**
+	 * Throws away the previous search and starts a new one from the goal.
+	 * @param level The level to search.
+	 * @param startIndex The index of the start tile.
+	 * @param goalIndex The index of the goal tile.
+	 */
+	void Initialize(const Level& level, int startIndex, int goalIndex);
+
+	/**
+	 * Calculates the priority of a node in the open list.
+	 * @param node The index of the node.
+	 * @return The lowest cost of the node plus the distance to the start, offset by how far the start has moved, then the lowest cost.
+	 */
+	long long CalculateKey(int node) const;
+
+	/**
+	 * Calculates the distance between two nodes that never overestimates the cost of the path between them.
+	 * @param first The index of the first node.
+	 * @param second The index of the second node.
+	 * @return The cost of the diagonal distance between the nodes.
+	 */
+	int Heuristic(int first, int second) const;
+
+	/**
+	 * Recalculates the cost of a node from its neighbors, and adds it to the open list if that doesn't match its current cost.
+	 * @param node The index of the node.
+	 */
+	void UpdateNode(int node);
+
+	/**
+	 * Expands nodes until the cost of the start is correct.
+	 */
+	void ComputeShortestPath();
+
+private:
+	/**
+	 * The level that the search was made on, and its size.
+	 */
+	const Level* m_level;
+	sf::Vector2i m_size;
+
+	/**
+	 * The layout revision of the level that the search is up to date with.
+	 */
+	unsigned int m_revision;
+
+	/**
+	 * Whether each tile could be walked on when the search last saw it.
+	 */
+	std::vector<bool> m_walkable;
+
+	/**
+	 * The cost of reaching the goal from each node, as last expanded.
+	 */
+	std::vector<int> m_G;
+
+	/**
+	 * The cost of reaching the goal from each node, looking one step ahead at its neighbors.
+	 */
+	std::vector<int> m_rhs;
+
+	/**
+	 * The nodes whose two costs don't match.
+	 */
+	NodeHeap m_openList;
+
+	/**
+	 * The indices of the start and goal tiles of the last search, or -1 before the first search.
+	 */
+	int m_startIndex;
+	int m_goalIndex;
+
+	/**
+	 * The total distance the start has moved since the search began, added to new keys so old keys stay valid.
+	 */
+	int m_keyModifier;
+
+	/**
+	 * Whether the last search repaired the one before it.
+	 */
+	bool m_isRepair;
+
+	/**
+	 * The number of nodes that the last search expanded and touched.
+	 */
+	int m_expandedNodeCount;
+	int m_touchedNodeCount;
+
+	/**
+	 * The tiles that have changed since the last search.
+	 */
+	std::vector<sf::Vector2i> m_changedTiles;
+};
+#endif
\ No newline at end of file
@@ -0,0 +1,129 @@
+//-------------------------------------------------------------------------------------
+// PathfindingScheduler.h
+//
+// THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A
+// PARTICULAR PURPOSE.
+//
+// Written by Dale Green. Copyright (c) Packt Publishing. All rights reserved.
+//-------------------------------------------------------------------------------------
+#ifndef PATHFINDINGSCHEDULER_H
+#define PATHFINDINGSCHEDULER_H
+
+#include "Enemy.h"
+#include "PathfindingBatch.h"
+
+// The number of nodes an A* search expands between checks of the frame budget.
+static int const PATHFINDING_SLICE_SIZE = 16;
+
+
+class PathfindingScheduler
+{
+public:
+	/**
+	 * Default constructor.
+	 */
+	PathfindingScheduler();
+
+	/**
+	 * Requests a new path for an enemy. The enemy keeps following its current path until the new one is found.
+	 * A request replaces any earlier request for the same enemy that hasn't finished.
+	 * @param enemy The enemy to find a path for.
+	 * @param startNode The tile to start from.
+	 * @param goalNode The tile to find a path to.
+	 * @param priority The order to run the request in, lowest first. Usually the distance to the player.
+	 */
+	void Request(Enemy* enemy, const Tile* startNode, const Tile* goalNode, float priority);
+
+	/**
+	 * Cancels the request for an enemy, if it has one. This must be done before an enemy with a request is destroyed.
+	 * @param enemy The enemy to cancel the request for.
+	 */
+	void Cancel(const Enemy* enemy);
+
+	/**
+	 * Cancels all requests.
+	 */
+	void Clear();
+
+	/**
+	 * Runs requests, closest first, until the time budget has been used up.
+	 * A* searches that don't finish in time carry on from where they stopped in the next update.
+	 * Other searches can't be split, so they always finish once started.
+	 * Given a batch, the requests instead run a group at a time across its worker threads, one request per thread, and the budget is checked between groups.
+	 * Searches in a batch can't be split either, so a group always finishes once started.
+	 * @param level The level to search.
+	 * @param mode The search to use, either A_STAR, JUMP_POINT_SEARCH or HIERARCHICAL.
+	 * @param hierarchy The abstract graph of the level, needed for HIERARCHICAL searches. It must be up to date with the level.
+	 * @param cache The paths found by earlier searches, or nullptr. Requests it holds finish without searching.
+	 * @param budget The time in microseconds that the searches can use.
+	 * @param batch The worker pool to run the searches on, or nullptr to run them on the calling thread.
+	 * @return The number of requests that finished.
+	 */
+	int Update(const Level& level, PATHFINDING_MODE mode, const PathfindingHierarchy* hierarchy, PathCache* cache, int budget, PathfindingBatch* batch = nullptr);
+
+	/**
+	 * Gets the number of requests that haven't finished.
+	 * @return The number of waiting and paused requests.
+	 */
+	int GetPendingCount() const;
+
+	/**
+	 * Gets the number of nodes expanded in the last update.
+	 * @return The number of nodes expanded by all searches in the last update.
+	 */
+	int GetExpandedNodeCount() const;
+
+private:
+	/**
+	 * A request that hasn't finished.
+	 */
+	struct PendingSearch {
+		Enemy* enemy;						// The enemy to find a path for.
+		const Tile* startNode;				// The tile to start from.
+		const Tile* goalNode;				// The tile to find a path to.
+		float priority;						// The order to run the request in, lowest first.
+		unsigned int order;					// The order the request was made in, used to break ties.
+		int context;						// The search context holding the paused search, or -1 if it hasn't started.
+		unsigned int revision;				// The walkability revision of the level when the search started.
+	};
+
+	/**
+	 * Releases the search context of a request, if it has one, so it can be used by another search.
+	 * @param search The request to release the context of.
+	 */
+	void ReleaseContext(PendingSearch& search);
+
+private:
+	/**
+	 * The requests that haven't finished.
+	 */
+	std::vector<PendingSearch> m_searches;
+
+	/**
+	 * The search contexts. Each paused search keeps its own context until it finishes.
+	 */
+	std::vector<PathfindingContext> m_contexts;
+
+	/**
+	 * The contexts that aren't holding a paused search.
+	 */
+	std::vector<int> m_freeContexts;
+
+	/**
+	 * The order number of the next request.
+	 */
+	unsigned int m_nextOrder;
+
+	/**
+	 * The number of nodes expanded in the last update.
+	 */
+	int m_expandedNodeCount;
+
+	/**
+	 * The path found by the last search.
+	 */
+	std::vector<sf::Vector2f> m_path;
+};
+#endif
\ No newline at end of file
@@ -30,9 +30,10 @@ class Player : public Entity
 {
 public:
     /**
-     * Default constructor.
+     * Constructor.
+     * @param seed The seed of the run, which the player's class, stats, and damage are chosen from.
      */
-    Player();
+    explicit Player(std::uint64_t seed);
 
     /**
      * Updates the player object.
@@ -164,5 +165,10 @@ private:
      * An array containing the character's traits.
      */
     PLAYER_TRAIT m_traits[PLAYER_TRAIT_COUNT];
+
+    /**
+     * The random number stream that the player's class, stats, and damage are chosen with.
+     */
+    Random m_random;
 };
 #endif
\ No newline at end of file
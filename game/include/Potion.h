@@ -12,14 +12,16 @@
 #define POTION_H
 
 #include "Item.h"
+#include "Random.h"
 
 class Potion : public Item
 {
 public:
     /**
-    * Default constructor.
+    * Constructor.
+    * @param random The random number stream to choose the potion's values with.
     */
-    Potion();
+    explicit Potion(Random& random);
 
     /**
      * Gets the attack value of the potion.
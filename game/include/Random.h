@@ -0,0 +1,71 @@
+//-------------------------------------------------------------------------------------
+// Random.h
+//
+// THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A
+// PARTICULAR PURPOSE.
+//
+// Written by Dale Green. Copyright (c) Packt Publishing. All rights reserved.
+//-------------------------------------------------------------------------------------
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <cstdint>
+
+class Random
+{
+public:
+	/**
+	 * Default constructor. Creates a generator with a seed of 0.
+	 */
+	Random();
+
+	/**
+	 * Creates a generator for one stream of a seed.
+	 * Different streams of the same seed produce unrelated numbers.
+	 * @param seed The seed to start from.
+	 * @param stream The stream of the seed to produce.
+	 */
+	Random(std::uint64_t seed, RANDOM_STREAM stream);
+
+	/**
+	 * Restarts the generator from a seed.
+	 * @param seed The seed to start from.
+	 * @param stream The stream of the seed to produce.
+	 */
+	void Seed(std::uint64_t seed, RANDOM_STREAM stream);
+
+	/**
+	 * Gets the next random number.
+	 * @return A random number that uses all 32 bits.
+	 */
+	std::uint32_t Next();
+
+	/**
+	 * Gets a random number between 0 and count - 1.
+	 * @param count The number of values to pick from. Must be above 0.
+	 * @return A random number in the range.
+	 */
+	int Next(int count);
+
+	/**
+	 * Gets the seed of one room of a run, so the room is the same whenever it is generated.
+	 * @param seed The seed of the run.
+	 * @param roomIndex The index of the room in the run. 0 is used for anything that lasts the whole run.
+	 * @return The seed of the room.
+	 */
+	static std::uint64_t GetRoomSeed(std::uint64_t seed, int roomIndex);
+
+private:
+	/**
+	 * The current state of the generator.
+	 */
+	std::uint64_t m_state;
+
+	/**
+	 * The odd number added to the state each step, which selects the stream.
+	 */
+	std::uint64_t m_increment;
+};
+#endif
\ No newline at end of file
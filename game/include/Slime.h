@@ -18,8 +18,9 @@ class Slime : public Enemy
 public:
 
     /**
-     * Default constructor.
+     * Constructor.
+     * @param random The random number stream to choose the slime's stats and color with.
      */
-    Slime();
+    explicit Slime(Random& random);
 };
 #endif
\ No newline at end of file
@@ -0,0 +1,246 @@
+//-------------------------------------------------------------------------------------
+// TileBitboard.h
+//
+// THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A
+// PARTICULAR PURPOSE.
+//
+// Written by Dale Green. Copyright (c) Packt Publishing. All rights reserved.
+//-------------------------------------------------------------------------------------
+#ifndef TILEBITBOARD_H
+#define TILEBITBOARD_H
+
+#include <cstdint>
+#include <vector>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/**
+ * Counts the set bits in a word.
+ * @param word The word to count the bits of.
+ * @return The number of set bits.
+ */
+inline int CountBits(std::uint64_t word)
+{
+#if defined(_MSC_VER) && defined(_M_X64)
+	return static_cast<int>(__popcnt64(word));
+#elif defined(_MSC_VER)
+	return static_cast<int>(__popcnt(static_cast<std::uint32_t>(word)) + __popcnt(static_cast<std::uint32_t>(word >> 32)));
+#else
+	return __builtin_popcountll(word);
+#endif
+}
+
+/**
+ * Finds the lowest set bit in a word.
+ * @param word The word to search. Must not be 0.
+ * @return The index of the lowest set bit.
+ */
+inline int FindLowestBit(std::uint64_t word)
+{
+#if defined(_MSC_VER) && defined(_M_X64)
+	unsigned long index;
+	_BitScanForward64(&index, word);
+	return static_cast<int>(index);
+#elif defined(_MSC_VER)
+	unsigned long index;
+	if (_BitScanForward(&index, static_cast<std::uint32_t>(word)))
+	{
+		return static_cast<int>(index);
+	}
+	_BitScanForward(&index, static_cast<std::uint32_t>(word >> 32));
+	return static_cast<int>(index) + 32;
+#else
+	return __builtin_ctzll(word);
+#endif
+}
+
+class TileBitboard
+{
+public:
+	/**
+	 * Default constructor. Creates an empty bitboard.
+	 */
+	TileBitboard();
+
+	/**
+	 * Creates a bitboard for a grid of tiles, with every bit clear.
+	 * @param size The number of columns and rows in the grid.
+	 */
+	explicit TileBitboard(sf::Vector2i size);
+
+	/**
+	 * Resizes the bitboard and clears every bit.
+	 * @param size The number of columns and rows in the grid.
+	 */
+	void Reset(sf::Vector2i size);
+
+	/**
+	 * Gets the size of the grid the bitboard covers.
+	 * @return The number of columns and rows.
+	 */
+	sf::Vector2i GetSize() const;
+
+	/**
+	 * Checks the bit of a tile. Tiles outside the grid are always clear.
+	 * @param columnIndex The column that the tile is in.
+	 * @param rowIndex The row that the tile is in.
+	 * @return True if the tile's bit is set.
+	 */
+	bool Test(int columnIndex, int rowIndex) const;
+
+	/**
+	 * Sets or clears the bit of a tile.
+	 * @param columnIndex The column that the tile is in. Must be inside the grid.
+	 * @param rowIndex The row that the tile is in. Must be inside the grid.
+	 * @param value Whether the bit is set.
+	 */
+	void Set(int columnIndex, int rowIndex, bool value);
+
+	/**
+	 * Counts the tiles whose bits are set.
+	 * @return The number of set bits.
+	 */
+	int Count() const;
+
+	/**
+	 * Gets a bitboard where each tile holds the bit of the tile at an offset from it, such as the tile above.
+	 * Tiles whose offset falls outside the grid are clear.
+	 * @param columnOffset The number of columns to the tile to read from.
+	 * @param rowOffset The number of rows to the tile to read from. Must be between -63 and 63.
+	 * @return The shifted bitboard.
+	 */
+	TileBitboard Shifted(int columnOffset, int rowOffset) const;
+
+	/**
+	 * Gets the bits of the eight tiles around a tile in one mask.
+	 * Bit (columnOffset + 1) * 3 + (rowOffset + 1) holds the tile at that offset, and bit 4, the tile itself, is always clear.
+	 * @param columnIndex The column that the tile is in.
+	 * @param rowIndex The row that the tile is in.
+	 * @return The mask of neighbouring tiles whose bits are set.
+	 */
+	int GetNeighborMask(int columnIndex, int rowIndex) const;
+
+	/**
+	 * Gets which of the four tiles beside a tile are set.
+	 * @param columnIndex The column that the tile is in.
+	 * @param rowIndex The row that the tile is in.
+	 * @return A mask of the set sides: 1 above, 2 right, 4 below, 8 left.
+	 */
+	int GetSideMask(int columnIndex, int rowIndex) const;
+
+	/**
+	 * Keeps only the bits that are also set in another bitboard of the same size.
+	 * @param other The bitboard to intersect with.
+	 * @return This bitboard.
+	 */
+	TileBitboard& operator&=(const TileBitboard& other);
+
+	/**
+	 * Sets every bit that is set in another bitboard of the same size.
+	 * @param other The bitboard to combine with.
+	 * @return This bitboard.
+	 */
+	TileBitboard& operator|=(const TileBitboard& other);
+
+	/**
+	 * Resizes the bitboard and sets the bit of every tile from a test, building each word before it is stored.
+	 * @param size The number of columns and rows in the grid.
+	 * @param isSet Called with the column and row of each tile, and returns whether its bit is set.
+	 */
+	template <typename Function>
+	void Assign(sf::Vector2i size, Function isSet)
+	{
+		Reset(size);
+		for (int i = 0; i < m_size.x; ++i)
+		{
+			std::uint64_t* column = &m_words[i * m_wordsPerColumn];
+			for (int j = 0; j < m_size.y; ++j)
+			{
+				column[j >> 6] |= static_cast<std::uint64_t>(isSet(i, j) ? 1 : 0) << (j & 63);
+			}
+		}
+	}
+
+	/**
+	 * Calls a function for every tile whose bit is set, in order of column then row.
+	 * @param function Called with the column and row of each tile.
+	 */
+	template <typename Function>
+	void ForEach(Function function) const
+	{
+		for (int i = 0; i < m_size.x; ++i)
+		{
+			const std::uint64_t* column = &m_words[i * m_wordsPerColumn];
+			for (int word = 0; word < m_wordsPerColumn; ++word)
+			{
+				// Take the lowest set bit each time until the word is empty.
+				for (std::uint64_t bits = column[word]; bits != 0; bits &= bits - 1)
+				{
+					function(i, word * 64 + FindLowestBit(bits));
+				}
+			}
+		}
+	}
+
+	/**
+	 * Calls a function for every tile whose bit is set, along with which of the four tiles beside it are set too.
+	 * The sides are worked out a word at a time with shifts, rather than by checking each neighbour.
+	 * @param function Called with the column and row of each tile, and a mask of its set sides: 1 above, 2 right, 4 below, 8 left.
+	 */
+	template <typename Function>
+	void ForEachWithSides(Function function) const
+	{
+		for (int i = 0; i < m_size.x; ++i)
+		{
+			const std::uint64_t* column = &m_words[i * m_wordsPerColumn];
+			const std::uint64_t* leftColumn = (i > 0) ? column - m_wordsPerColumn : nullptr;
+			const std::uint64_t* rightColumn = (i + 1 < m_size.x) ? column + m_wordsPerColumn : nullptr;
+			for (int word = 0; word < m_wordsPerColumn; ++word)
+			{
+				// Line each neighbour's bit up with the tile's own. The rows above and below carry across words.
+				std::uint64_t above = (column[word] << 1) | ((word > 0) ? (column[word - 1] >> 63) : 0);
+				std::uint64_t below = (column[word] >> 1) | ((word + 1 < m_wordsPerColumn) ? (column[word + 1] << 63) : 0);
+				std::uint64_t right = (rightColumn != nullptr) ? rightColumn[word] : 0;
+				std::uint64_t left = (leftColumn != nullptr) ? leftColumn[word] : 0;
+
+				for (std::uint64_t bits = column[word]; bits != 0; bits &= bits - 1)
+				{
+					int bit = FindLowestBit(bits);
+					int sides = static_cast<int>(((above >> bit) & 1) | (((right >> bit) & 1) << 1) | (((below >> bit) & 1) << 2) | (((left >> bit) & 1) << 3));
+					function(i, word * 64 + bit, sides);
+				}
+			}
+		}
+	}
+
+private:
+	/**
+	 * Gets the bits of a run of tiles in a column. Bits of tiles outside the grid are clear.
+	 * @param columnIndex The column to read from.
+	 * @param rowIndex The first row to read. Can be above the grid.
+	 * @param count The number of rows to read, up to 32.
+	 * @return The bits, with the first row in the lowest bit.
+	 */
+	std::uint64_t GetColumnBits(int columnIndex, int rowIndex, int count) const;
+
+private:
+	/**
+	 * The number of columns and rows in the grid.
+	 */
+	sf::Vector2i m_size;
+
+	/**
+	 * The number of words that hold each column.
+	 */
+	int m_wordsPerColumn;
+
+	/**
+	 * The bits, one per tile. Each column takes whole words, with row 0 in the lowest bit of its first word.
+	 * The bits past the last row of a column are always clear.
+	 */
+	std::vector<std::uint64_t> m_words;
+};
+#endif
\ No newline at end of file
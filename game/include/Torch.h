@@ -12,15 +12,17 @@
 #define TORCH_H
 
 #include "Item.h"
+#include "Random.h"
 
 class Torch : public Object
 {
 public:
 
 	/**
-	 * Default Constructor.
+	 * Constructor.
+	 * @param seed The seed of the torch's flicker.
 	 */
-	Torch();
+	explicit Torch(std::uint64_t seed);
 
 	/**
 	 * Updates the brightness of the torch.
@@ -40,5 +42,10 @@ private:
 	 * The brightness modifier of the torch. This is used to denote flicker.
 	 */
 	float m_brightness;
+
+	/**
+	 * The random number stream that the flicker is made with.
+	 */
+	Random m_random;
 };
 #endif
\ No newline at end of file
@@ -11,6 +11,8 @@
 #ifndef UTIL_H
 #define UTIL_H
 
+#include <cstdint>
+
 // Game states.
 enum class GAME_STATE {
 	MAIN_MENU,
@@ -56,7 +58,7 @@ enum class ANIMATION_STATE {
 };
 
 // Tiles.
-enum class TILE {
+enum class TILE : std::uint8_t {
 	WALL_SINGLE,
 	WALL_TOP_END,
 	WALL_SIDE_RIGHT_END,
@@ -143,6 +145,25 @@ enum class MUSIC_TRACK {
     COUNT
 };
 
+// Enemy pathfinding modes.
+enum class PATHFINDING_MODE {
+    A_STAR,
+    JUMP_POINT_SEARCH,
+    HIERARCHICAL,
+    INCREMENTAL,
+    NEXT_HOP_TABLE,
+    FLOW_FIELD,
+    COUNT
+};
+
+// The state of a pathfinding search that runs in steps.
+enum class PATHFINDING_STATUS {
+    IN_PROGRESS,
+    FOUND,
+    NOT_FOUND,
+    COUNT
+};
+
 // Ambient sound effects
 enum class AMBIENT_SOUND {
     OWL_HOOT,
@@ -150,4 +171,19 @@ enum class AMBIENT_SOUND {
     CRICKETS,
     COUNT
 };
+
+// Independent random number streams, one for each part of the game.
+enum class RANDOM_STREAM {
+    LEVEL,
+    SPAWNS,
+    ENEMIES,
+    ITEMS,
+    LOOT,
+    GOALS,
+    PLAYER,
+    COMBAT,
+    EFFECTS,
+    AUDIO,
+    COUNT
+};
 #endif
\ No newline at end of file
@@ -3,19 +3,21 @@
 #include "Enemy.h"
 
 
-// Default constructor.
-Enemy::Enemy()
+// Constructor.
+Enemy::Enemy(Random& random) :
+m_expandedNodeCount(0),
+m_flowField(nullptr)
 {
 	// Set stats.
-	m_health = std::rand() % 41 + 80;
-	m_attack = std::rand() % 11 + 6;
-	m_defense = std::rand() % 11 + 6;
-	m_strength = std::rand() % 11 + 6;
-	m_dexterity = std::rand() % 11 + 6;
-	m_stamina = std::rand() % 11 + 6;
+	m_health = random.Next(41) + 80;
+	m_attack = random.Next(11) + 6;
+	m_defense = random.Next(11) + 6;
+	m_strength = random.Next(11) + 6;
+	m_dexterity = random.Next(11) + 6;
+	m_stamina = random.Next(11) + 6;
 
 	// Set speed.
-	m_speed = rand() % 51 + 150;
+	m_speed = random.Next(51) + 150;
 }
 
 
@@ -24,6 +26,20 @@ void Enemy::Update(float timeDelta, Level &level)
 {
     sf::Vector2f previousPosition = m_position;
 
+    // If following a flow field, take the next waypoint from it.
+    if ((m_targetPositions.empty()) && (m_flowField != nullptr))
+    {
+        sf::Vector2f waypoint;
+        if (m_flowField->GetNextWaypoint(level, m_position, waypoint))
+        {
+            m_targetPositions.push_back(waypoint);
+        }
+        else
+        {
+            m_flowField = nullptr;
+        }
+    }
+
     // Move towards current target location.
     if (!m_targetPositions.empty())
     {
@@ -87,155 +103,129 @@ bool Enemy::IsDead()
 }
 
 // Calculate an amount of damage to an enemy.
-int Enemy::CalculateDamage()
+int Enemy::CalculateDamage(Random& random)
 {
     float damage_scale(1.f);
     damage_scale += ENEMY_DEXTERITY_DAMAGE_SCALE * m_dexterity;
 
-    float damage = (std::rand() % (ENEMY_MAX_DAMAGE + 1)) + (ENEMY_ATTACK_DAMAGE_SCALE * m_attack);
+    float damage = (random.Next(ENEMY_MAX_DAMAGE + 1)) + (ENEMY_ATTACK_DAMAGE_SCALE * m_attack);
     return static_cast<int>(damage * damage_scale);
 }
 
 
-// Updates the target position of the enemy.
-void Enemy::UpdatePathfinding(Level &level, sf::Vector2f playerPosition)
+// Gets the target positions of the enemy.
+const std::vector<sf::Vector2f>& Enemy::GetTargetPositions() const
 {
-    // Reset all nodes.
-    level.ResetNodes();
+    return m_targetPositions;
+}
 
+// Gets the number of nodes that the last pathfinding search expanded.
+int Enemy::GetExpandedNodeCount() const
+{
+    return m_expandedNodeCount;
+}
+
+// Updates the target position of the enemy.
+void Enemy::UpdatePathfinding(const Level &level, sf::Vector2f playerPosition, PathfindingContext &context, PATHFINDING_MODE mode)
+{
     // Store the start and goal nodes.
-    Tile* startNode = level.GetTile(m_position);
-    Tile* goalNode = level.GetTile(playerPosition);
+    const Tile* startNode = level.GetTile(m_position);
+    const Tile* goalNode = level.GetTile(playerPosition);
 
-    // Check we have a valid path to find. If not we can just end the
-    // function as there's no path to find.
-    if (startNode == goalNode)
+    // Search for a path and store the node locations as the enemies target locations.
+    if (mode == PATHFINDING_MODE::JUMP_POINT_SEARCH)
     {
-        m_targetPositions.clear();
-        return;
+        context.FindJumpPointPath(level, startNode, goalNode, m_targetPositions);
     }
-
-    // Step 1: Calculate the Manhattan distance for each tile on the level.
-    for (int i = 0; i < level.GetSize().x; i++)
+    else
     {
-        for (int j = 0; j < level.GetSize().y; j++)
-        {
-            Tile* node = level.GetTile(i, j);
-            int heightOffset = std::abs(node->rowIndex - goalNode->rowIndex);
-            int widthOffset = std::abs(node->columnIndex - goalNode->columnIndex);
-            node->H = heightOffset + widthOffset;
-        }
+        context.FindPath(level, startNode, goalNode, m_targetPositions);
     }
+    m_expandedNodeCount = context.GetExpandedNodeCount();
+    m_flowField = nullptr;
+}
 
-    std::vector<Tile*> openList;
-    std::vector<Tile*> closedList;
-    std::vector<Tile*> pathList;
-    std::vector<Tile*>::iterator position;
-    Tile* currentNode = nullptr;
+// Updates the target position of the enemy, reusing a cached path if there is one.
+void Enemy::UpdatePathfinding(const Level &level, sf::Vector2f playerPosition, PathfindingContext &context, PathCache &cache, PATHFINDING_MODE mode)
+{
+    const Tile* startNode = level.GetTile(m_position);
+    const Tile* goalNode = level.GetTile(playerPosition);
 
-    openList.push_back(startNode);
-    while(!openList.empty())
+    if (cache.Find(level, startNode, goalNode, m_targetPositions))
     {
-        // Step 2: Find the node in the open list with the lowest F value and mark it as current.
-        int lowestF = INT_MAX;
-        for (Tile* tile: openList)
-        {
-            if (tile->F < lowestF)
-            {
-                lowestF = tile->F;
-                currentNode = tile;
-            }
-        }
+        m_expandedNodeCount = 0;
+        m_flowField = nullptr;
+        return;
+    }
+
+    UpdatePathfinding(level, playerPosition, context, mode);
+    cache.Store(level, startNode, goalNode, m_targetPositions);
+}
 
-        // Remove the current node from the open list and add it to the closed list.
-        position = std::find(openList.begin(), openList.end(), currentNode);
-        if (position != openList.end()) openList.erase(position);
-        closedList.push_back(currentNode);
+// Updates the target position of the enemy through the abstract graph of a pathfinding hierarchy.
+void Enemy::UpdatePathfinding(const Level &level, sf::Vector2f playerPosition, const PathfindingHierarchy &hierarchy, PathfindingContext &context)
+{
+    context.FindHierarchicalPath(level, hierarchy, level.GetTile(m_position), level.GetTile(playerPosition), m_targetPositions);
+    m_expandedNodeCount = context.GetExpandedNodeCount();
+    m_flowField = nullptr;
+}
 
-        // Step 3: Find all adjacent tiles
-        std::vector<Tile*> adjacentTiles;
-        Tile* node;
+// Updates the target position of the enemy with its own incremental planner.
+void Enemy::UpdatePathfinding(const Level &level, sf::Vector2f playerPosition)
+{
+    m_planner.FindPath(level, level.GetTile(m_position), level.GetTile(playerPosition), m_targetPositions);
+    m_expandedNodeCount = m_planner.GetExpandedNodeCount();
+    m_flowField = nullptr;
+}
 
-        for (int i = -1; i <= 1; i++)
-        {
-            for (int j = -1; j <= 1; j++)
-            {
-                node = level.GetTile(currentNode->columnIndex + i, currentNode->rowIndex + j);
-                if ((node != nullptr) && (level.IsFloor(*node)) && (node != currentNode))
-                {
-                    adjacentTiles.push_back(node);
-                }
-            }
-        }
+// Updates the target position of the enemy from a table of precomputed first steps.
+void Enemy::UpdatePathfinding(const Level &level, sf::Vector2f playerPosition, const NextHopTable &nextHopTable)
+{
+    nextHopTable.FindPath(level, level.GetTile(m_position), level.GetTile(playerPosition), m_targetPositions);
+    m_expandedNodeCount = 0;
+    m_flowField = nullptr;
+}
 
-        // For all adjacent nodes.
-        for (Tile* adjacentNode: adjacentTiles)
-        {
-            if (adjacentNode == goalNode)
-            {
-                // Parent the goal node to current.
-                adjacentNode->parentNode = currentNode;
-
-                // Store the current path.
-                while (adjacentNode->parentNode != nullptr)
-                {
-                    pathList.push_back(adjacentNode);
-                    adjacentNode = adjacentNode->parentNode;
-                }
-
-                // Empty the open list and break out of our for loop.
-                openList.clear();
-                break;
-            }
-            else
-            {
-                // If the node is not in the closed list.
-                position = std::find(closedList.begin(), closedList.end(), adjacentNode);
-                if (position == closedList.end())
-                {
-                    // If the node is not in the open list.
-                    position = std::find(openList.begin(), openList.end(), adjacentNode);
-                    if (position == openList.end())
-                    {
-                        // Add the node to the open list.
-                        openList.push_back(adjacentNode);
-
-                        // Set the parent of the node to the current node.
-                        adjacentNode->parentNode = currentNode;
-
-                        // Calculate G (total movement cost so far) cost.
-                        adjacentNode->G = currentNode->G + ENEMY_PATHFINDING_STEP_COST;
-
-                        // Calculate the F (total movement cost + heuristic) cost.
-                        adjacentNode->F = adjacentNode->G + adjacentNode->H;
-                    }
-                    else
-                    {
-                        // Check if this path is quicker that the other.
-                        int tempG = currentNode->G + ENEMY_PATHFINDING_STEP_COST;
-
-                        // Check if tempG is faster than the other. I.e, whether it's
-                        // faster to go A->C->B that A->C.
-                        if (tempG < adjacentNode->G)
-                        {
-                            // Re-parent node to this one.
-                            adjacentNode->parentNode = currentNode;
-                        }
-                    }
-                }
-            }
-        }
+// Sets the player as the only target position of the enemy if the way to it is clear.
+bool Enemy::UpdateDirectPath(const LineOfSight &lineOfSight, sf::Vector2f playerPosition)
+{
+    if (!lineOfSight.IsClear(m_position, playerPosition, ENTITY_COLLISION_HALF_SIZE))
+    {
+        return false;
     }
 
-    // Clear the vector of target positions.
+    m_targetPositions.assign(1, playerPosition);
+    m_expandedNodeCount = 0;
+    m_flowField = nullptr;
+    return true;
+}
+
+// Sets the path of the enemy to one found by a search that ran elsewhere.
+void Enemy::SetPath(const std::vector<sf::Vector2f>& path, int expandedNodeCount)
+{
+    m_targetPositions = path;
+    m_expandedNodeCount = expandedNodeCount;
+    m_flowField = nullptr;
+}
+
+// Makes the enemy follow a flow field towards its goal.
+void Enemy::UpdatePathfinding(const Level &level, const FlowField &flowField)
+{
+    m_flowField = &flowField;
+    m_expandedNodeCount = 0;
+
+    // Replace the current waypoints with the next step towards the goal.
     m_targetPositions.clear();
 
-    // Store the node locations as the enemies target locations.
-    for (Tile* tile : pathList)
+    sf::Vector2f waypoint;
+    if (flowField.GetNextWaypoint(level, m_position, waypoint))
     {
-        m_targetPositions.push_back(level.GetActualTileLocation(tile->columnIndex, tile->rowIndex));
+        m_targetPositions.push_back(waypoint);
     }
+}
 
-    // Reverse the target position as we read them from goal to origin and we need them the other way around.
-    std::reverse(m_targetPositions.begin(), m_targetPositions.end());
+// Stops the enemy following a flow field once it reaches its current waypoint.
+void Enemy::ClearFlowField()
+{
+    m_flowField = nullptr;
 }
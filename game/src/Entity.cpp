@@ -166,16 +166,16 @@ bool Entity::CausesCollision(sf::Vector2f movement, Level& level)
     sf::Vector2f newPosition = m_position + movement;
 
     // Top left.
-    overlappingTiles[0] = level.GetTile(sf::Vector2f(newPosition.x - 14.f, newPosition.y - 14.f));
+    overlappingTiles[0] = level.GetTile(sf::Vector2f(newPosition.x - ENTITY_COLLISION_HALF_SIZE, newPosition.y - ENTITY_COLLISION_HALF_SIZE));
 
     // Top right.
-    overlappingTiles[1] = level.GetTile(sf::Vector2f(newPosition.x + 14.f, newPosition.y - 14.f));
+    overlappingTiles[1] = level.GetTile(sf::Vector2f(newPosition.x + ENTITY_COLLISION_HALF_SIZE, newPosition.y - ENTITY_COLLISION_HALF_SIZE));
 
     // Bottom left.
-    overlappingTiles[2] = level.GetTile(sf::Vector2f(newPosition.x - 14.f, newPosition.y + 14.f));
+    overlappingTiles[2] = level.GetTile(sf::Vector2f(newPosition.x - ENTITY_COLLISION_HALF_SIZE, newPosition.y + ENTITY_COLLISION_HALF_SIZE));
 
     // Bottom right.
-    overlappingTiles[3] = level.GetTile(sf::Vector2f(newPosition.x + 14.f, newPosition.y + 14.f));
+    overlappingTiles[3] = level.GetTile(sf::Vector2f(newPosition.x + ENTITY_COLLISION_HALF_SIZE, newPosition.y + ENTITY_COLLISION_HALF_SIZE));
 
     // If any of the overlapping tiles are solid there was a collision.
     for (int i = 0; i < 4; i++)
@@ -0,0 +1,101 @@
+#include "PCH.h"
+#include "FlowField.h"
+
+// Default constructor.
+FlowField::FlowField() :
+m_size({ 0, 0 })
+{
+}
+
+// Calculates the step distance from every floor tile in the level to the goal tile.
+void FlowField::Build(const Level& level, const Tile* goalNode)
+{
+    m_size = level.GetSize();
+    m_distances.assign(m_size.x * m_size.y, -1);
+    m_openList.clear();
+
+    if (goalNode == nullptr)
+    {
+        return;
+    }
+
+    // Breadth first search outwards from the goal. Every step has the same cost, so
+    // tiles are reached in order of their distance.
+    int goalIndex = goalNode->columnIndex * m_size.y + goalNode->rowIndex;
+    m_distances[goalIndex] = 0;
+    m_openList.push_back(goalIndex);
+
+    for (size_t next = 0; next < m_openList.size(); ++next)
+    {
+        int currentIndex = m_openList[next];
+        int currentColumn = currentIndex / m_size.y;
+        int currentRow = currentIndex % m_size.y;
+        int distance = m_distances[currentIndex] + 1;
+
+        for (int i = -1; i <= 1; i++)
+        {
+            for (int j = -1; j <= 1; j++)
+            {
+                const Tile* node = level.GetTile(currentColumn + i, currentRow + j);
+                if ((node == nullptr) || (!level.IsFloor(*node)))
+                {
+                    continue;
+                }
+
+                int index = node->columnIndex * m_size.y + node->rowIndex;
+                if (m_distances[index] == -1)
+                {
+                    m_distances[index] = distance;
+                    m_openList.push_back(index);
+                }
+            }
+        }
+    }
+}
+
+// Gets the number of steps from a tile to the goal.
+int FlowField::GetDistance(int columnIndex, int rowIndex) const
+{
+    if ((columnIndex < 0) || (columnIndex >= m_size.x) || (rowIndex < 0) || (rowIndex >= m_size.y))
+    {
+        return -1;
+    }
+
+    return m_distances[columnIndex * m_size.y + rowIndex];
+}
+
+// Gets the next waypoint towards the goal by descending the distance field.
+bool FlowField::GetNextWaypoint(const Level& level, sf::Vector2f position, sf::Vector2f& waypoint) const
+{
+    const Tile* currentNode = level.GetTile(position);
+    int currentDistance = GetDistance(currentNode->columnIndex, currentNode->rowIndex);
+    if (currentDistance == 0)
+    {
+        return false;
+    }
+
+    // Find the adjacent tile that is closest to the goal.
+    int bestDistance = currentDistance;
+    const Tile* bestNode = nullptr;
+
+    for (int i = -1; i <= 1; i++)
+    {
+        for (int j = -1; j <= 1; j++)
+        {
+            int distance = GetDistance(currentNode->columnIndex + i, currentNode->rowIndex + j);
+            if ((distance != -1) && ((bestDistance == -1) || (distance < bestDistance)))
+            {
+                bestDistance = distance;
+                bestNode = level.GetTile(currentNode->columnIndex + i, currentNode->rowIndex + j);
+            }
+        }
+    }
+
+    if (bestNode == nullptr)
+    {
+        return false;
+    }
+
+    waypoint = level.GetActualTileLocation(bestNode->columnIndex, bestNode->rowIndex);
+    return true;
+}
@@ -1,12 +1,16 @@
+#include <algorithm>
 #include <cmath>
 #include "PCH.h"
 #include "Game.h"
 
 // Default constructor.
-Game::Game(sf::RenderWindow* window) :
+Game::Game(sf::RenderWindow* window, std::uint64_t seed) :
 m_window(*window),
 m_gameState(GAME_STATE::PLAYING),
 m_isRunning(true),
+m_avoidedSearchCount(0),
+m_seed(seed),
+m_player(seed),
 m_string(""),
 m_screenSize({ 0, 0 }),
 m_screenCenter({ 0, 0 }),
@@ -14,6 +18,7 @@ m_scoreTotal(0),
 m_goldTotal(0),
 m_projectileTextureID(0),
 m_levelWasGenerated(false),
+m_playerPreviousTile(nullptr),
 m_killGoal(0),
 m_goldGoal(0),
 m_gemGoal(0),
@@ -29,8 +34,9 @@ m_activeGoal(false)
     // Calculate and store the center of the screen.
     m_screenCenter = { m_window.getSize().x / 2.f, m_window.getSize().y / 2.f };
 
-    // Create the level object.
-    m_level = Level(*window);
+    // Create the level object, and seed it and everything else for the run.
+    m_level = CreateLevel();
+    SeedRun(seed);
 
     // Create the game font.
     m_font.loadFromFile("../resources/fonts/PexicoRegular.otf");
@@ -77,11 +83,11 @@ void Game::Initialize()
     m_views[static_cast<int>(VIEW::UI)] = m_window.getDefaultView();
 
     // Generate some random FLOOR_ALT tiles on the level.
-    int tiles_count = std::rand() % MAX_FLOOR_ALT_COUNT;
+    int tiles_count = GetRandomStream(RANDOM_STREAM::EFFECTS).Next(MAX_FLOOR_ALT_COUNT);
     SpawnRandomTiles(TILE::FLOOR_ALT, tiles_count);
 
     // Setup the main game music.
-    int trackIndex = (std::rand() % static_cast<int>(MUSIC_TRACK::COUNT)) + 1;
+    int trackIndex = GetRandomStream(RANDOM_STREAM::AUDIO).Next(static_cast<int>(MUSIC_TRACK::COUNT)) + 1;
 
     // Load the music track.
     m_music.openFromFile("../resources/music/msc_main_track_" + std::to_string(trackIndex) + ".wav");
@@ -127,7 +133,7 @@ void Game::Initialize()
     // Load and play ambient sounds
     for(int i = 0; i < AMBIENT_SOUNDS_COUNT; ++i)
     {
-        int soundIndex = (std::rand() % static_cast<int>(AMBIENT_SOUND ::COUNT)) + 1;
+        int soundIndex = GetRandomStream(RANDOM_STREAM::AUDIO).Next(static_cast<int>(AMBIENT_SOUND ::COUNT)) + 1;
 
         std::string soundPath = "../resources/ambient/level_track_" + std::to_string(soundIndex) + ".wav";
         soundBufferId = SoundBufferManager::AddSoundBuffer(soundPath);
@@ -139,7 +145,7 @@ void Game::Initialize()
         sound->setAttenuation(5.f);
         sound->setVolume(75);
 
-        sf::Vector2f position = m_level.GetRandomSpawnLocation();
+        sf::Vector2f position = m_level.GetRandomSpawnLocation(GetRandomStream(RANDOM_STREAM::AUDIO));
         sound->setPosition(position.x, position.y, 0.f);
 
         sound->play();
@@ -350,32 +356,26 @@ void Game::LoadUI()
 }
 
 // Populate the level with items.
-void Game::PopulateLevel()
+void Game::PopulateLevel(const SpawnPlan& spawnPlan)
 {
-    for (int i = 0; i < MAX_ITEM_SPAWN_COUNT; i++)
+    // Add a key to the level. A streamed floor has no door, so it has no key either.
+    Random& random = GetRandomStream(RANDOM_STREAM::ITEMS);
+    if (!LEVEL_STREAMING_ENABLED)
     {
-        if (std::rand() % 2)
-        {
-            // Choose a random item type.
-            int itemType = std::rand() % (static_cast<int>(ITEM::COUNT) - 1);
-
-            // Spawn an item in the certain position.
-            SpawnItem(static_cast<ITEM>(itemType));
-        }
+        SpawnItem(ITEM::KEY, random, spawnPlan.keyLocation);
     }
 
-    for (int i = 0; i < MAX_ENEMY_SPAWN_COUNT; i++)
+    // Spawn each item in its chosen position.
+    for (const auto& item : spawnPlan.items)
     {
-        if (std::rand() % 2)
-        {
-            // Choose a random enemy type.
-            int enemyType = std::rand() % static_cast<int>(ENEMY::COUNT);
-
-            // Spawn an enemy.
-            SpawnEnemy(static_cast<ENEMY>(enemyType));
-        }
+        SpawnItem(item.first, random, item.second);
     }
 
+    // Spawn each enemy in its chosen position.
+    for (const auto& enemy : spawnPlan.enemies)
+    {
+        SpawnEnemy(enemy.first, enemy.second);
+    }
 }
 
 // Returns the running state of the game.
@@ -384,6 +384,12 @@ bool Game::IsRunning()
     return m_isRunning;
 }
 
+// Gets the number of enemy pathfinding searches that were skipped because the enemy could move straight to the player.
+long long Game::GetAvoidedSearchCount() const
+{
+    return m_avoidedSearchCount;
+}
+
 // Main game loop.
 void Game::Run()
 {
@@ -415,8 +421,12 @@ void Game::Run()
                 m_gemGoal = 0;
                 m_goalString = "";
                 m_activeGoal = false;
-                m_player = Player();
-                m_level = Level(m_window);
+                m_levelGenerator.Cancel();
+                m_level = CreateLevel();
+
+                // Each new run follows on from the seed of the last one.
+                SeedRun(m_seed + 1);
+                m_player = Player(m_seed);
 
                 m_gameState = GAME_STATE::PLAYING;
                 Initialize();
@@ -460,12 +470,13 @@ void Game::Update(float timeDelta)
         // First check if the player is at the exit. If so there's no need to update anything.
         Tile& playerTile = *m_level.GetTile(m_player.GetPosition());
 
-        if (playerTile.type == TILE::WALL_DOOR_UNLOCKED)
+        if (m_level.GetTileType(playerTile.columnIndex, playerTile.rowIndex) == TILE::WALL_DOOR_UNLOCKED)
         {
             // Clear all current items.
             m_items.clear();
 
             // Clear all current enemies.
+            m_pathfindingScheduler.Clear();
             m_enemies.clear();
 
             // Generate a new room.
@@ -482,6 +493,15 @@ void Game::Update(float timeDelta)
             // Store the player position as it's used many times.
             sf::Vector2f playerPosition = m_player.GetPosition();
 
+            // Keep an endless floor streamed in around the player.
+            if ((LEVEL_STREAMING_ENABLED) && (m_levelStreamer.Update(m_level, playerPosition)))
+            {
+                m_level.BindSprites();
+                m_pathfindingScheduler.Clear();
+                RemoveObjectsOutsideLevel();
+                m_playerPreviousTile = nullptr;
+            }
+
             // Move the audio listener to the players location.
             sf::Listener::setPosition(playerPosition.x, playerPosition.y, 0.f);
 
@@ -514,6 +534,18 @@ void Game::Update(float timeDelta)
             // Center the view.
             m_views[static_cast<int>(VIEW::MAIN)].setCenter(playerPosition);
 
+            // Catch the abstract graph up with any tiles that have changed, such as an unlocked door.
+            if (ENEMY_PATHFINDING_MODE == PATHFINDING_MODE::HIERARCHICAL)
+            {
+                m_pathfindingHierarchy.Update(m_level);
+            }
+
+            // Rebuild the next hop table once a tile has changed between floor and solid. Until it's ready enemies search with A*.
+            if ((ENEMY_PATHFINDING_MODE == PATHFINDING_MODE::NEXT_HOP_TABLE) && (!m_nextHopTable.IsReady(m_level)) && (!m_nextHopTable.IsBuilding()))
+            {
+                m_nextHopTable.BuildInBackground(m_level);
+            }
+
             // Check if the player has moved grid square.
             Tile* playerCurrentTile = m_level.GetTile(playerPosition);
             if (m_playerPreviousTile != playerCurrentTile)
@@ -521,22 +553,84 @@ void Game::Update(float timeDelta)
                 // Store the new tile.
                 m_playerPreviousTile = playerCurrentTile;
 
+                // Rebuild the distance field towards the player once for all enemies.
+                if (ENEMY_PATHFINDING_MODE == PATHFINDING_MODE::FLOW_FIELD)
+                {
+                    m_flowField.Build(m_level, playerCurrentTile);
+                }
+
                 // Update path finding for all enemies if within range of the player.
+                m_pathfindingBatch.Clear();
+                m_pathfindingEnemies.clear();
+                m_lineOfSight.Update(m_level);
+
                 for (const auto& enemy : m_enemies)
                 {
                     if (DistanceBetweenPoints(enemy->GetPosition(), playerPosition) < 200.f)
                     {
-                        enemy->UpdatePathfinding(m_level, playerPosition);
+                        if (enemy->UpdateDirectPath(m_lineOfSight, playerPosition))
+                        {
+                            // Nothing is in the way, so the enemy heads straight for the player in any mode, without a search or the flow field.
+                            // A search queued earlier would replace the direct path with an older one.
+                            m_pathfindingScheduler.Cancel(enemy.get());
+                            m_avoidedSearchCount++;
+                        }
+                        else if (ENEMY_PATHFINDING_MODE == PATHFINDING_MODE::FLOW_FIELD)
+                        {
+                            enemy->UpdatePathfinding(m_level, m_flowField);
+                        }
+                        else if ((ENEMY_PATHFINDING_MODE == PATHFINDING_MODE::NEXT_HOP_TABLE) && m_nextHopTable.IsReady(m_level))
+                        {
+                            enemy->UpdatePathfinding(m_level, playerPosition, m_nextHopTable);
+                        }
+                        else if (ENEMY_PATHFINDING_MODE == PATHFINDING_MODE::INCREMENTAL)
+                        {
+                            // Each enemy repairs its own search, which is usually much cheaper than a new one.
+                            enemy->UpdatePathfinding(m_level, playerPosition);
+                        }
+                        else if (ENEMY_PATHFINDING_BUDGET > 0)
+                        {
+                            // Queue the search, closest enemies first. The enemy follows its old path until the new one is found.
+                            m_pathfindingScheduler.Request(enemy.get(), m_level.GetTile(enemy->GetPosition()), playerCurrentTile, DistanceBetweenPoints(enemy->GetPosition(), playerPosition));
+                        }
+                        else
+                        {
+                            // Collect the searches so they can run together.
+                            m_pathfindingBatch.Add(m_level.GetTile(enemy->GetPosition()), playerCurrentTile);
+                            m_pathfindingEnemies.push_back(enemy.get());
+                        }
+                    }
+                    else
+                    {
+                        // Out of range enemies finish their current step and stop chasing.
+                        m_pathfindingScheduler.Cancel(enemy.get());
+                        enemy->ClearFlowField();
+                    }
+                }
+
+                // Run the searches across the worker threads, then hand the paths out before the enemies next move.
+                if (!m_pathfindingEnemies.empty())
+                {
+                    m_pathfindingBatch.Run(m_level, ENEMY_PATHFINDING_MODE, &m_pathfindingHierarchy, &m_pathCache);
+                    for (size_t i = 0; i < m_pathfindingEnemies.size(); ++i)
+                    {
+                        m_pathfindingEnemies[i]->SetPath(m_pathfindingBatch.GetPath(static_cast<int>(i)), m_pathfindingBatch.GetExpandedNodeCount(static_cast<int>(i)));
                     }
                 }
             }
 
+            // Run as many queued searches as fit in this frame's budget, across the worker threads.
+            if (ENEMY_PATHFINDING_BUDGET > 0)
+            {
+                m_pathfindingScheduler.Update(m_level, ENEMY_PATHFINDING_MODE, &m_pathfindingHierarchy, &m_pathCache, ENEMY_PATHFINDING_BUDGET, &m_pathfindingBatch);
+            }
+
             // Check if we have completed an active goal.
             if (m_activeGoal)
             {
                 if ((m_gemGoal <= 0) && (m_goldGoal <= 0) && (m_killGoal <= 0))
                 {
-                    m_scoreTotal += std::rand() % 1001 + 1000;
+                    m_scoreTotal += GetRandomStream(RANDOM_STREAM::LOOT).Next(1001) + 1000;
                     m_activeGoal = false;
                 }
                 else {
@@ -571,6 +665,7 @@ void Game::Update(float timeDelta)
         m_uiSprites.clear();
         m_playerProjectiles.clear();
         m_lightGrid.clear();
+        m_pathfindingScheduler.Clear();
         m_enemies.clear();
         m_items.clear();
         break;
@@ -801,34 +896,36 @@ void Game::UpdateEnemies(sf::Vector2f playerPosition, float timeDelta, Level &le
                     sf::Vector2f position = enemy.GetPosition();
 
                     // Spawn loot.
+                    Random& loot = GetRandomStream(RANDOM_STREAM::LOOT);
                     for (int i = 0; i < 5; i++)
                     {
-                        position.x += std::rand() % 31 - 15;
-                        position.y += std::rand() % 31 - 15;
+                        position.x += loot.Next(31) - 15;
+                        position.y += loot.Next(31) - 15;
 
-                        int itemType = std::rand() % 2;
-                        SpawnItem(static_cast<ITEM>(itemType), position);
+                        int itemType = loot.Next(2);
+                        SpawnItem(static_cast<ITEM>(itemType), loot, position);
                     }
 
-                    if ((std::rand() % 5) == 0)			// 1 in 5 change of spawning health.
+                    if (loot.Next(5) == 0)			// 1 in 5 change of spawning health.
                     {
-                        position.x += std::rand() % 31 - 15;
-                        position.y += std::rand() % 31 - 15;
-                        std::unique_ptr<Item> heart = std::make_unique<Heart>();
+                        position.x += loot.Next(31) - 15;
+                        position.y += loot.Next(31) - 15;
+                        std::unique_ptr<Item> heart = std::make_unique<Heart>(loot);
                         heart->SetPosition(position);
                         m_items.push_back(std::move(heart));
                     }
                     // 1 in 5 change of spawning potion.
-                    else if ((std::rand() % 5) == 1)
+                    else if (loot.Next(5) == 1)
                     {
-                        position.x += std::rand() % 31 - 15;
-                        position.y += std::rand() % 31 - 15;
-                        std::unique_ptr<Item> potion = std::make_unique<Potion>();
+                        position.x += loot.Next(31) - 15;
+                        position.y += loot.Next(31) - 15;
+                        std::unique_ptr<Item> potion = std::make_unique<Potion>(loot);
                         potion->SetPosition(position);
                         m_items.push_back(std::move(potion));
                     }
 
                     // Delete enemy.
+                    m_pathfindingScheduler.Cancel(&enemy);
                     enemyIterator = m_enemies.erase(enemyIterator);
                     enemyWasDeleted = true;
 
@@ -864,7 +961,7 @@ void Game::UpdateEnemies(sf::Vector2f playerPosition, float timeDelta, Level &le
         {
             if (m_player.CanTakeDamage())
             {
-                m_player.Damage(enemy.CalculateDamage());
+                m_player.Damage(enemy.CalculateDamage(GetRandomStream(RANDOM_STREAM::COMBAT)));
 
                 // Play the sound for a hitting the player.
                 PlaySound(m_playerHitSound);
@@ -883,10 +980,10 @@ void Game::UpdateProjectiles(float timeDelta)
         Projectile& projectile = **projectileIterator;
 
         // Get the tile that the projectile is on.
-        TILE projectileTileType = m_level.GetTile(projectile.GetPosition())->type;
+        const Tile* projectileTile = m_level.GetTile(projectile.GetPosition());
 
         // If the tile the projectile is on is not floor, delete it.
-        if ((projectileTileType != TILE::FLOOR) && (projectileTileType != TILE::FLOOR_ALT))
+        if (!m_level.IsFloor(*projectileTile))
         {
             projectileIterator = m_playerProjectiles.erase(projectileIterator);
         }
@@ -1091,7 +1188,7 @@ void Game::Draw(float timeDelta)
 }
 
 // Spawns a given item in the level.
-void Game::SpawnItem(ITEM itemType, sf::Vector2f position)
+void Game::SpawnItem(ITEM itemType, Random& random, sf::Vector2f position)
 {
     // Choose a random, unused spawn location.
     sf::Vector2f spawnLocation;
@@ -1100,7 +1197,7 @@ void Game::SpawnItem(ITEM itemType, sf::Vector2f position)
         spawnLocation = position;
     }
     else {
-        spawnLocation = m_level.GetRandomSpawnLocation();
+        spawnLocation = m_level.GetRandomSpawnLocation(random);
     }
 
     std::unique_ptr<Item> item;
@@ -1108,22 +1205,22 @@ void Game::SpawnItem(ITEM itemType, sf::Vector2f position)
     switch (itemType)
     {
         case ITEM::POTION:
-            item = std::make_unique<Potion>();
+            item = std::make_unique<Potion>(random);
             break;
         case ITEM::GEM:
-            item = std::make_unique<Gem>();
+            item = std::make_unique<Gem>(random);
             break;
         case ITEM::GOLD:
-            item = std::make_unique<Gold>();
+            item = std::make_unique<Gold>(random);
             break;
         case ITEM::KEY:
             item = std::make_unique<Key>();
             break;
         case ITEM::HEART:
-            item = std::make_unique<Heart>();
+            item = std::make_unique<Heart>(random);
             break;
         default:
-            item = std::make_unique<Gem>();
+            item = std::make_unique<Gem>(random);
             break;
     }
     // Set the item position.
@@ -1136,6 +1233,8 @@ void Game::SpawnItem(ITEM itemType, sf::Vector2f position)
 // Spawns a given enemy in the level.
 void Game::SpawnEnemy(ENEMY enemyType, sf::Vector2f position)
 {
+    Random& random = GetRandomStream(RANDOM_STREAM::ENEMIES);
+
     // Spawn location of enemy.
     sf::Vector2f spawnLocation;
     // Choose a random, unused spawn location.
@@ -1144,7 +1243,7 @@ void Game::SpawnEnemy(ENEMY enemyType, sf::Vector2f position)
         spawnLocation = position;
     }
     else {
-        spawnLocation = m_level.GetRandomSpawnLocation();
+        spawnLocation = m_level.GetRandomSpawnLocation(random);
     }
 
     // Create the enemy.
@@ -1152,13 +1251,13 @@ void Game::SpawnEnemy(ENEMY enemyType, sf::Vector2f position)
     switch (enemyType)
     {
         case ENEMY::SLIME:
-            enemy = std::make_unique<Slime>();
+            enemy = std::make_unique<Slime>(random);
             break;
         case ENEMY::HUMANOID:
-            enemy = std::make_unique<Humanoid>();
+            enemy = std::make_unique<Humanoid>(random);
             break;
         default:
-            enemy = std::make_unique<Slime>();
+            enemy = std::make_unique<Slime>(random);
             break;
     }
     // Set spawn position.
@@ -1171,6 +1270,8 @@ void Game::SpawnEnemy(ENEMY enemyType, sf::Vector2f position)
 // Spawns a given number of a certain tile at random locations in the level.
 void Game::SpawnRandomTiles(TILE tileType, int count)
 {
+    Random& random = GetRandomStream(RANDOM_STREAM::EFFECTS);
+
     // Loop the number of tiles we need.
     for (int i = 0; i < count; i++)
     {
@@ -1181,8 +1282,8 @@ void Game::SpawnRandomTiles(TILE tileType, int count)
         while (!m_level.IsFloor(columnIndex, rowIndex))
         {
             // Generate a random index for the row and column.
-            columnIndex = std::rand() % GRID_WIDTH;
-            rowIndex = std::rand() % GRID_HEIGHT;
+            columnIndex = random.Next(m_level.GetSize().x);
+            rowIndex = random.Next(m_level.GetSize().y);
         }
 
         // Now we change the selected tile.
@@ -1195,7 +1296,7 @@ void Game::SpawnRandomTiles(TILE tileType, int count)
 void Game::PlaySound(sf::Sound& sound, sf::Vector2f position)
 {
     // Generate and set a random pitch.
-    float pitch = (rand() % 11 + 95) / 100.f;
+    float pitch = (GetRandomStream(RANDOM_STREAM::AUDIO).Next(11) + 95) / 100.f;
     sound.setPitch(pitch);
 
     // Set the position of the sound.
@@ -1210,30 +1311,32 @@ void Game::GenerateLevelGoal()
 {
     std::ostringstream ss;
 
+    Random& goals = GetRandomStream(RANDOM_STREAM::GOALS);
+
     // Reset our goal variables.
     m_killGoal = 0;
     m_goldGoal = 0;
     m_gemGoal = 0;
 
     // Choose which type of goal is to be generated.
-    int goalType = rand() % 3;
+    int goalType = goals.Next(3);
     switch (goalType)
     {
         // Kill X enemies
         case 0:
-            m_killGoal = rand() % 6 + 5;
+            m_killGoal = goals.Next(6) + 5;
             ss << "Current Goal: Kill " << m_killGoal << " enemies" << "." << std::endl;
             break;
 
         // Collect X Gold
         case 1:
-            m_goldGoal = rand() % 51 + 50;
+            m_goldGoal = goals.Next(51) + 50;
             ss << "Current Goal: Collect " << m_goldGoal << " gold" << "." << std::endl;
             break;
 
         // Collect X Gems
         case 2:
-            m_gemGoal = rand() % 6 + 5;
+            m_gemGoal = goals.Next(6) + 5;
             ss << "Current Goal: Collect " << m_gemGoal << " gems" << "." << std::endl;
             break;
 
@@ -1249,21 +1352,97 @@ void Game::GenerateLevelGoal()
 
 void Game::GenerateLevel()
 {
-    // Generate a new level.
-    m_level.GenerateLevel();
+    // Swap in the room that was generated while the last one was played. The first room has to be generated now.
+    SpawnPlan spawnPlan;
+    if (LEVEL_STREAMING_ENABLED)
+    {
+        // An endless floor is streamed in around the start, and is only populated there.
+        m_levelStreamer.Reset(m_seed);
+        m_levelStreamer.Update(m_level, LevelStreamer::GetStartLocation());
+        m_level.BindSprites();
+        LevelGenerator::PlanSpawns(m_level, spawnPlan);
+    }
+    else if (m_levelGenerator.IsStarted())
+    {
+        m_levelGenerator.Finish(m_level, spawnPlan);
+    }
+    else
+    {
+        m_level.GenerateLevel();
+        LevelGenerator::PlanSpawns(m_level, spawnPlan);
+    }
 
-    // Add a key to the level.
-    SpawnItem(ITEM::KEY);
+    // Seed the streams that the room uses, so a seed and room index always give the same room.
+    std::uint64_t roomSeed = Random::GetRoomSeed(m_seed, m_level.GetRoomIndex());
+    for (RANDOM_STREAM stream : { RANDOM_STREAM::ENEMIES, RANDOM_STREAM::ITEMS, RANDOM_STREAM::LOOT, RANDOM_STREAM::GOALS })
+    {
+        GetRandomStream(stream).Seed(roomSeed, stream);
+    }
+
+    // Precompute the paths between every pair of tiles while the level is being populated and played.
+    if (ENEMY_PATHFINDING_MODE == PATHFINDING_MODE::NEXT_HOP_TABLE)
+    {
+        m_nextHopTable.BuildInBackground(m_level);
+    }
 
-    // Populate the level with items.
-    PopulateLevel();
+    // Populate the level with items and enemies.
+    PopulateLevel(spawnPlan);
 
     // 1 in 3 change of creating a level goal.
-    if (((std::rand() % 3) == 0) && (!m_activeGoal))
+    if ((GetRandomStream(RANDOM_STREAM::GOALS).Next(3) == 0) && (!m_activeGoal))
     {
         GenerateLevelGoal();
     }
 
     // Moves the player to the start.
-    m_player.SetPosition(m_level.SpawnLocation());
+    m_player.SetPosition(LEVEL_STREAMING_ENABLED ? LevelStreamer::GetStartLocation() : m_level.SpawnLocation());
+
+    // Force enemy pathfinding to update for the new layout.
+    m_pathfindingScheduler.Clear();
+    m_playerPreviousTile = nullptr;
+
+    // Start generating the next room while this one is played.
+    if (!LEVEL_STREAMING_ENABLED)
+    {
+        m_levelGenerator.Start(m_level);
+    }
+
+}
+
+// Creates an empty level, the right size for the kind of floor being played.
+Level Game::CreateLevel()
+{
+    if (LEVEL_STREAMING_ENABLED)
+    {
+        return Level(m_window, LevelStreamer::GetLevelSize());
+    }
+    return Level(m_window);
+}
+
+// Removes the enemies, items, and projectiles that are no longer inside the level.
+void Game::RemoveObjectsOutsideLevel()
+{
+    auto isOutside = [this](const auto& object) { return !m_level.IsInside(object->GetPosition()); };
+    m_items.erase(std::remove_if(m_items.begin(), m_items.end(), isOutside), m_items.end());
+    m_enemies.erase(std::remove_if(m_enemies.begin(), m_enemies.end(), isOutside), m_enemies.end());
+    m_playerProjectiles.erase(std::remove_if(m_playerProjectiles.begin(), m_playerProjectiles.end(), isOutside), m_playerProjectiles.end());
+}
+
+// Starts a new run from a seed.
+void Game::SeedRun(std::uint64_t seed)
+{
+    m_seed = seed;
+    m_level.SetSeed(seed);
+
+    // Start every stream for the run. The ones that rooms use are seeded again for each room.
+    for (int i = 0; i < static_cast<int>(RANDOM_STREAM::COUNT); ++i)
+    {
+        m_randomStreams[i].Seed(Random::GetRoomSeed(seed, 0), static_cast<RANDOM_STREAM>(i));
+    }
+}
+
+// Gets one of the game's random number streams.
+Random& Game::GetRandomStream(RANDOM_STREAM stream)
+{
+    return m_randomStreams[static_cast<int>(stream)];
 }
@@ -1,14 +1,14 @@
 #include "PCH.h"
 #include "Gem.h"
 
-// Default Constructor.
-Gem::Gem()
+// Constructor.
+Gem::Gem(Random& random)
 {
 	// Set the sprite.
 	SetSprite(TextureManager::GetTexture(TextureManager::AddTexture("../resources/loot/gem/spr_pickup_gem.png")), false, 8, 12);
 
 	// Set the value of the gem.
-	m_scoreValue = std::rand() % 100;
+	m_scoreValue = random.Next(100);
 
 	// Set the item type.
 	m_type = ITEM::GEM;
@@ -1,11 +1,11 @@
 #include "PCH.h"
 #include "Gold.h"
 
-// Default constructor.
-Gold::Gold()
+// Constructor.
+Gold::Gold(Random& random)
 {
 	// Set gold value.
-	this->goldValue = std::rand() % 21 + 5;
+	this->goldValue = random.Next(21) + 5;
 
 	// Set the sprite.
 	int textureID;
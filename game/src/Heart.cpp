@@ -1,14 +1,14 @@
 #include "PCH.h"
 #include "Heart.h"
 
-// Default constructor.
-Heart::Heart()
+// Constructor.
+Heart::Heart(Random& random)
 {
 	// Set item sprite.
 	SetSprite(TextureManager::GetTexture(TextureManager::AddTexture("../resources/loot/heart/spr_pickup_heart.png")), false, 8, 12);
 
 	// Set health value.
-	m_health = std::rand() % 11 + 10;
+	m_health = random.Next(11) + 10;
 
 	// Set item type.
 	m_type = ITEM::HEART;
@@ -2,11 +2,12 @@
 #include "Humanoid.h"
 
 // TODO: Implement procedurally armor generation for enemies
-// Default constructor.
-Humanoid::Humanoid()
+// Constructor.
+Humanoid::Humanoid(Random& random) :
+Enemy(random)
 {
     // Generate a humanoid type.
-    HUMANOID humanoidType = static_cast<HUMANOID>(std::rand() % static_cast<int>(HUMANOID::COUNT));
+    HUMANOID humanoidType = static_cast<HUMANOID>(random.Next(static_cast<int>(HUMANOID::COUNT)));
     std::string enemyName;
 
     // Set enemy specific variables.
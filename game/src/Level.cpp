@@ -1,18 +1,93 @@
+#include <algorithm>
+#include <cmath>
 #include "PCH.h"
 #include "Level.h"
 
-// Default constructor.
-Level::Level()
+// The type of wall for each combination of walls beside it: 1 above, 2 right, 4 below, 8 left.
+static TILE const WALL_TYPES_BY_SIDES[16] = {
+    TILE::WALL_SINGLE,
+    TILE::WALL_TOP_END,
+    TILE::WALL_SIDE_RIGHT_END,
+    TILE::WALL_BOTTOM_LEFT,
+    TILE::WALL_BOTTOM_END,
+    TILE::WALL_SIDE,
+    TILE::WALL_TOP_LEFT,
+    TILE::WALL_SIDE_LEFT_T,
+    TILE::WALL_SIDE_LEFT_END,
+    TILE::WALL_BOTTOM_RIGHT,
+    TILE::WALL_TOP,
+    TILE::WALL_BOTTOM_T,
+    TILE::WALL_TOP_RIGHT,
+    TILE::WALL_SIDE_RIGHT_T,
+    TILE::WALL_TOP_T,
+    TILE::WALL_INTERSECTION
+};
+
+// Constructor.
+// Creates a level without any tile textures. This is used for headless tools such as benchmarks.
+Level::Level(sf::Vector2i size) :
+m_size(std::max(size.x, GRID_MIN_SIZE) | 1, std::max(size.y, GRID_MIN_SIZE) | 1),
+m_grid(m_size.x * m_size.y),
+m_tileTypes(m_size.x * m_size.y, TILE::EMPTY),
+m_walkableTiles(m_size),
+m_wallTiles(m_size),
+m_doorTiles(m_size),
+m_reachableMask(m_size),
+m_reachableRevision(0),
+m_origin({ 0, 0 }),
+m_floorNumber(1),
+m_roomNumber(0),
+m_doorTileIndices({ 0, 0 }),
+m_seed(0),
+m_tileColor(sf::Color::White),
+m_layoutRevision(1),
+m_layoutResetRevision(1),
+m_walkabilityRevision(1)
 {
+    // Mark all tile textures as missing.
+    for (int& textureID : m_textureIDs)
+    {
+        textureID = -1;
+    }
+
+    // Store the column and row information for each node.
+    for (int i = 0; i < m_size.x; i++)
+    {
+        for (int j = 0; j < m_size.y; j++)
+        {
+            auto cell = &m_grid[i * m_size.y + j];
+            cell->columnIndex = i;
+            cell->rowIndex = j;
+        }
+    }
 }
 
 // Constructor.
-Level::Level(sf::RenderWindow& window) : 
+Level::Level(sf::RenderWindow& window, sf::Vector2i size) :
+m_size(std::max(size.x, GRID_MIN_SIZE) | 1, std::max(size.y, GRID_MIN_SIZE) | 1),
+m_grid(m_size.x * m_size.y),
+m_tileTypes(m_size.x * m_size.y, TILE::EMPTY),
+m_walkableTiles(m_size),
+m_wallTiles(m_size),
+m_doorTiles(m_size),
+m_reachableMask(m_size),
+m_reachableRevision(0),
 m_origin({ 0, 0 }),
 m_floorNumber(1),
 m_roomNumber(0),
-m_doorTileIndices({ 0, 0 })
+m_doorTileIndices({ 0, 0 }),
+m_seed(0),
+m_tileColor(sf::Color::White),
+m_layoutRevision(1),
+m_layoutResetRevision(1),
+m_walkabilityRevision(1)
 {
+    // Mark all tile textures as missing until they are added.
+    for (int& textureID : m_textureIDs)
+    {
+        textureID = -1;
+    }
+
     // Load all tiles.
     AddTile("../resources/tiles/spr_tile_floor.png", TILE::FLOOR);
     AddTile("../resources/tiles/spr_tile_floor_alt.png", TILE::FLOOR_ALT);
@@ -42,24 +117,22 @@ m_doorTileIndices({ 0, 0 })
     AddTile("../resources/tiles/spr_tile_door_unlocked.png", TILE::WALL_DOOR_UNLOCKED);
 
     // Calculate the top left of the grid.
-    m_origin.x = (window.getSize().x - (GRID_WIDTH * TILE_SIZE));
+    m_origin.x = (window.getSize().x - (m_size.x * TILE_SIZE));
     m_origin.x /= 2;
 
-    m_origin.y = (window.getSize().y - (GRID_HEIGHT * TILE_SIZE));
+    m_origin.y = (window.getSize().y - (m_size.y * TILE_SIZE));
     m_origin.y /= 2;
 
     // Store the column and row information for each node.
-    for (int i = 0; i < GRID_WIDTH; i++)
+    for (int i = 0; i < m_size.x; i++)
     {
-        for (int j = 0; j < GRID_HEIGHT; j++)
+        for (int j = 0; j < m_size.y; j++)
         {
-            auto cell = &m_grid[i][j];
+            auto cell = &m_grid[i * m_size.y + j];
             cell->columnIndex = i;
             cell->rowIndex = j;
         }
     }
-
-    SetRandomColor();
 }
 
 // Create and adds a tile sprite to the list of those available.
@@ -87,8 +160,7 @@ bool Level::IsSolid(int i, int j)
     // Check that the tile is valid
     if (TileIsValid(i, j))
     {
-        int tileIndex = static_cast<int>(m_grid[i][j].type);
-        return (((tileIndex != static_cast<int>(TILE::FLOOR)) && (tileIndex != static_cast<int>(TILE::FLOOR_ALT))) && (tileIndex != static_cast<int>(TILE::WALL_DOOR_UNLOCKED)));
+        return HasTileFlag(m_tileTypes[i * m_size.y + j], TILE_FLAG_SOLID);
     }
     else
         return false;
@@ -104,20 +176,20 @@ sf::Vector2f Level::GetPosition() const
 TILE Level::GetTileType(int columnIndex, int rowIndex) const
 {
     // Check that the parameters are valid.
-    if ((columnIndex >= GRID_WIDTH) || (rowIndex >= GRID_HEIGHT))
+    if ((columnIndex >= m_size.x) || (rowIndex >= m_size.y))
     {
         return TILE::EMPTY; // failed
     }
 
     // Fetch the id.
-    return m_grid[columnIndex][rowIndex].type;
+    return m_tileTypes[columnIndex * m_size.y + rowIndex];
 }
 
 // Sets the id of the given tile in the grid.
 void Level::SetTile(int columnIndex, int rowIndex, TILE tileType)
 {
     // Check that the provided tile index is valid.
-    if ((columnIndex >= GRID_WIDTH) || (rowIndex >= GRID_HEIGHT))
+    if ((columnIndex >= m_size.x) || (rowIndex >= m_size.y))
     {
         return;
     }
@@ -128,9 +200,112 @@ void Level::SetTile(int columnIndex, int rowIndex, TILE tileType)
         return;
     }
 
-    // change that tiles sprite to the new index
-    m_grid[columnIndex][rowIndex].type = tileType;
-    m_grid[columnIndex][rowIndex].sprite.setTexture(TextureManager::GetTexture(m_textureIDs[static_cast<int>(tileType)]));
+    // Paths only need to be recalculated if the tile changes between floor and solid.
+    if (IsFloor(columnIndex, rowIndex) != HasTileFlag(tileType, TILE_FLAG_FLOOR))
+    {
+        m_walkabilityRevision++;
+    }
+
+    // A wall's type comes from the walls beside it, whatever type of wall it was given.
+    bool wasWall = m_wallTiles.Test(columnIndex, rowIndex);
+    SetTileType(columnIndex, rowIndex, tileType);
+    if (HasTileFlag(tileType, TILE_FLAG_WALL))
+    {
+        SetTileType(columnIndex, rowIndex, WALL_TYPES_BY_SIDES[m_wallTiles.GetSideMask(columnIndex, rowIndex)]);
+    }
+    RefreshTile(columnIndex, rowIndex);
+
+    // If the tile became or stopped being a wall, the walls beside it may need a different type too. Nothing further away can change.
+    if (wasWall != m_wallTiles.Test(columnIndex, rowIndex))
+    {
+        sf::Vector2i const sides[] = { { 0, -1 }, { 1, 0 }, { 0, 1 }, { -1, 0 } };
+        for (const sf::Vector2i& side : sides)
+        {
+            int i = columnIndex + side.x;
+            int j = rowIndex + side.y;
+            if (m_wallTiles.Test(i, j))
+            {
+                TILE type = WALL_TYPES_BY_SIDES[m_wallTiles.GetSideMask(i, j)];
+                if (m_tileTypes[i * m_size.y + j] != type)
+                {
+                    SetTileType(i, j, type);
+                    RefreshTile(i, j);
+                }
+            }
+        }
+    }
+}
+
+// Sets the sprite of a tile to match its type, and records that it changed.
+void Level::RefreshTile(int columnIndex, int rowIndex)
+{
+    if (!m_tileSprites.empty())
+    {
+        m_tileSprites[columnIndex * m_size.y + rowIndex].setTexture(TextureManager::GetTexture(m_textureIDs[static_cast<int>(m_tileTypes[columnIndex * m_size.y + rowIndex])]));
+    }
+
+    // Record the change so that anything built from the layout can be updated around it.
+    if (static_cast<int>(m_changedTiles.size()) >= MAX_TRACKED_TILE_CHANGES)
+    {
+        ResetLayoutRevision();
+    }
+    else
+    {
+        m_changedTiles.push_back(sf::Vector2i(columnIndex, rowIndex));
+        m_layoutRevision++;
+    }
+}
+
+// Gets the revision of the level layout.
+unsigned int Level::GetLayoutRevision() const
+{
+    return m_layoutRevision;
+}
+
+// Gets the tiles that have been set since the given layout revision.
+bool Level::GetChangedTiles(unsigned int revision, std::vector<sf::Vector2i>& tiles) const
+{
+    tiles.clear();
+
+    if ((revision < m_layoutResetRevision) || (revision > m_layoutRevision))
+    {
+        return false;
+    }
+
+    tiles.assign(m_changedTiles.begin() + (revision - m_layoutResetRevision), m_changedTiles.end());
+    return true;
+}
+
+// Gets the revision of the walkable tiles in the level.
+unsigned int Level::GetWalkabilityRevision() const
+{
+    return m_walkabilityRevision;
+}
+
+// Records that the whole layout has been replaced.
+void Level::ResetLayoutRevision()
+{
+    m_changedTiles.clear();
+    m_layoutRevision++;
+    m_layoutResetRevision = m_layoutRevision;
+    m_walkabilityRevision++;
+}
+
+// Sets the type of a tile and updates the bitboards.
+void Level::SetTileType(int columnIndex, int rowIndex, TILE tileType)
+{
+    m_tileTypes[columnIndex * m_size.y + rowIndex] = tileType;
+    m_walkableTiles.Set(columnIndex, rowIndex, HasTileFlag(tileType, TILE_FLAG_FLOOR));
+    m_wallTiles.Set(columnIndex, rowIndex, HasTileFlag(tileType, TILE_FLAG_WALL));
+    m_doorTiles.Set(columnIndex, rowIndex, HasTileFlag(tileType, TILE_FLAG_DOOR));
+}
+
+// Builds the bitboards from the tile types.
+void Level::BuildBitboards()
+{
+    m_walkableTiles.Assign(m_size, [this](int i, int j) { return HasTileFlag(m_tileTypes[i * m_size.y + j], TILE_FLAG_FLOOR); });
+    m_wallTiles.Assign(m_size, [this](int i, int j) { return HasTileFlag(m_tileTypes[i * m_size.y + j], TILE_FLAG_WALL); });
+    m_doorTiles.Assign(m_size, [this](int i, int j) { return HasTileFlag(m_tileTypes[i * m_size.y + j], TILE_FLAG_DOOR); });
 }
 
 // Gets the current floor number.
@@ -145,28 +320,147 @@ int Level::GetRoomNumber() const
     return m_roomNumber;
 }
 
+// Gets the index of the current room in the run.
+int Level::GetRoomIndex() const
+{
+    return ((m_floorNumber - 1) * ROOMS_PER_FLOOR) + m_roomNumber;
+}
+
+// Gets the seed of the run that the level belongs to.
+std::uint64_t Level::GetSeed() const
+{
+    return m_seed;
+}
+
+// Sets the seed of the run that the level belongs to.
+void Level::SetSeed(std::uint64_t seed)
+{
+    m_seed = seed;
+    m_random.Seed(Random::GetRoomSeed(m_seed, GetRoomIndex()), RANDOM_STREAM::LEVEL);
+    SetRandomColor();
+}
+
 // Get the reachable tiles on the level.
-const std::vector<sf::Vector2f> Level::GetReachableTiles() const
+const std::vector<sf::Vector2f>& Level::GetReachableTiles() const
 {
+    UpdateReachableTiles();
     return m_reachableTiles;
 }
 
+// Gets the reachable tiles on the level, one bit per tile.
+const TileBitboard& Level::GetReachableMask() const
+{
+    UpdateReachableTiles();
+    return m_reachableMask;
+}
+
+// Checks if a tile can be walked to from the spawn tile.
+bool Level::IsReachable(int columnIndex, int rowIndex) const
+{
+    return GetReachableMask().Test(columnIndex, rowIndex);
+}
+
+// Gets the tile that the player spawns on.
+bool Level::GetSpawnTile(sf::Vector2i& tile) const
+{
+    // Work in tiles before converting, so positions just outside the level don't round onto it.
+    tile.x = static_cast<int>(std::floor((m_spawnLocation.x - m_origin.x) / TILE_SIZE));
+    tile.y = static_cast<int>(std::floor((m_spawnLocation.y - m_origin.y) / TILE_SIZE));
+    return (tile.x >= 0) && (tile.x < m_size.x) && (tile.y >= 0) && (tile.y < m_size.y);
+}
+
+// Works out the reachable tiles with a flood fill from the spawn tile.
+void Level::UpdateReachableTiles() const
+{
+    // Only walkable tiles matter, so the last result holds until one of them changes.
+    if (m_reachableRevision == m_walkabilityRevision)
+    {
+        return;
+    }
+    m_reachableRevision = m_walkabilityRevision;
+
+    sf::Vector2i spawn;
+    if ((!GetSpawnTile(spawn)) || (!m_walkableTiles.Test(spawn.x, spawn.y)))
+    {
+        // With no floor to start from, every floor tile is treated as reachable, as it was before reachability was worked out.
+        m_reachableMask = m_walkableTiles;
+    }
+    else
+    {
+        // Fill outwards from the spawn tile. Each tile is marked as it is pushed, so none is pushed twice.
+        m_reachableMask.Reset(m_size);
+        m_reachableMask.Set(spawn.x, spawn.y, true);
+        std::vector<sf::Vector2i> openTiles(1, spawn);
+
+        sf::Vector2i const sides[] = { { 0, -1 }, { 1, 0 }, { 0, 1 }, { -1, 0 } };
+        while (!openTiles.empty())
+        {
+            sf::Vector2i tile = openTiles.back();
+            openTiles.pop_back();
+
+            for (const sf::Vector2i& side : sides)
+            {
+                int i = tile.x + side.x;
+                int j = tile.y + side.y;
+                if ((m_walkableTiles.Test(i, j)) && (!m_reachableMask.Test(i, j)))
+                {
+                    m_reachableMask.Set(i, j, true);
+                    openTiles.push_back(sf::Vector2i(i, j));
+                }
+            }
+        }
+    }
+
+    m_reachableTiles.clear();
+    m_reachableTiles.reserve(m_reachableMask.Count());
+    m_reachableMask.ForEach([this](int i, int j)
+    {
+        m_reachableTiles.push_back(GetActualTileLocation(i, j));
+    });
+}
+
 
 // Checks if a given tile is valid.
-bool Level::TileIsValid(int column, int row)
+bool Level::TileIsValid(int column, int row) const
 {
     bool validColumn, validRow;
 
-    validColumn = ((column >= 0) && (column < GRID_WIDTH));
-    validRow = ((row >= 0) && (row < GRID_HEIGHT));
+    validColumn = ((column >= 0) && (column < m_size.x));
+    validRow = ((row >= 0) && (row < m_size.y));
 
     return (validColumn && validRow);
 }
 
+// Checks if a position lies on one of the level's tiles.
+bool Level::IsInside(sf::Vector2f position) const
+{
+    position.x -= m_origin.x;
+    position.y -= m_origin.y;
+    return (position.x >= 0.f) && (position.y >= 0.f) && TileIsValid(static_cast<int>(position.x) / TILE_SIZE, static_cast<int>(position.y) / TILE_SIZE);
+}
+
 // Gets the size of the level in terms of tiles.
 sf::Vector2i Level::GetSize() const
 {
-    return sf::Vector2i(GRID_WIDTH, GRID_HEIGHT);
+    return m_size;
+}
+
+// Gets the floor tiles of the level, one bit per tile.
+const TileBitboard& Level::GetWalkableTiles() const
+{
+    return m_walkableTiles;
+}
+
+// Gets the wall tiles of the level, one bit per tile.
+const TileBitboard& Level::GetWallTiles() const
+{
+    return m_wallTiles;
+}
+
+// Gets the door tiles of the level, one bit per tile.
+const TileBitboard& Level::GetDoorTiles() const
+{
+    return m_doorTiles;
 }
 
 // Gets the tile that the position lies on.
@@ -182,7 +476,23 @@ Tile* Level::GetTile(sf::Vector2f position)
     tileColumn = static_cast<int>(position.x) / TILE_SIZE;
     tileRow = static_cast<int>(position.y) / TILE_SIZE;
 
-    return &m_grid[tileColumn][tileRow];
+    return &m_grid[tileColumn * m_size.y + tileRow];
+}
+
+// Gets the tile that the position lies on.
+const Tile* Level::GetTile(sf::Vector2f position) const
+{
+    // Convert the position to relative to the level grid.
+    position.x -= m_origin.x;
+    position.y -= m_origin.y;
+
+    // Convert to a tile position.
+    int tileColumn, tileRow;
+
+    tileColumn = static_cast<int>(position.x) / TILE_SIZE;
+    tileRow = static_cast<int>(position.y) / TILE_SIZE;
+
+    return &m_grid[tileColumn * m_size.y + tileRow];
 }
 
 // Returns a pointer to the tile at the given index.
@@ -190,7 +500,7 @@ Tile* Level::GetTile(int columnIndex, int rowIndex)
 {
     if (TileIsValid(columnIndex, rowIndex))
     {
-        return &m_grid[columnIndex][rowIndex];
+        return &m_grid[columnIndex * m_size.y + rowIndex];
     }
     else
     {
@@ -198,84 +508,132 @@ Tile* Level::GetTile(int columnIndex, int rowIndex)
     }
 }
 
-// Loads a level from a .txt file.
-bool Level::LoadLevelFromFile(std::string fileName)
+// Returns a const pointer to the tile at the given index.
+const Tile* Level::GetTile(int columnIndex, int rowIndex) const
 {
-    // Create all the fields we need.
-    std::ifstream file(fileName);
+    if (TileIsValid(columnIndex, rowIndex))
+    {
+        return &m_grid[columnIndex * m_size.y + rowIndex];
+    }
+    else
+    {
+        return nullptr;
+    }
+}
 
-    // Read level data into 2D int array that describes the level.
-    if (file.is_open())
+// Loads a level from a binary level file.
+bool Level::LoadLevelFromFile(std::string fileName)
+{
+    // The file is mapped and checked, and the tiles are read straight out of the mapping.
+    LevelFile file;
+    if (!file.Open(fileName))
     {
-        for (int j = 0; j < GRID_HEIGHT; ++j)
-        {
-            for (int i = 0; i < GRID_WIDTH; ++i)
-            {
-                // Get the cell that we're working on.
-                auto& cell = m_grid[i][j];
+        return false;
+    }
 
-                // Read the character. Out of 4 characters we only want 2nd and 3rd.
-                std::string input;
+    LoadLevel(file);
+    return true;
+}
 
-                file.get();
-                input += file.get();
-                input += file.get();
-                file.get();
+// Loads a level from a level pack.
+bool Level::LoadLevelFromPack(const LevelPack& pack, int levelID)
+{
+    // The level is checked where it lies in the pack, and nothing is copied out until its tiles are read.
+    LevelFile file;
+    if (!pack.GetLevel(levelID, file))
+    {
+        return false;
+    }
 
-                // Convert string to int.
-                std::stringstream convert(input);
-                int tileID;
-                convert >> tileID;
+    LoadLevel(file);
+    return true;
+}
 
-                // Set type, sprite and position.
-                cell.type = static_cast<TILE>(tileID);
-                cell.sprite.setTexture(TextureManager::GetTexture(m_textureIDs[tileID]));
-                cell.sprite.setPosition(m_origin.x + (TILE_SIZE * i), m_origin.y + (TILE_SIZE * j));
+// Builds the level in the binary level format.
+void Level::Serialize(std::vector<unsigned char>& data) const
+{
+    std::vector<sf::Vector2i> torches;
+    for (const sf::Vector2f& location : m_torchLocations)
+    {
+        const Tile* tile = GetTile(location);
+        torches.push_back(sf::Vector2i(tile->columnIndex, tile->rowIndex));
+    }
 
-                // Check for entry/exit nodes.
-                if (cell.type == TILE::WALL_DOOR_LOCKED)
-                {
-                    // Save the location of the exit door.
-                    m_doorTileIndices = sf::Vector2i(i, 0);
-                }
-            }
-            file.get(); // Carriage return
-            file.get(); // New line
-        }
+    std::vector<sf::Vector2i> spawns;
+    sf::Vector2i spawn;
+    if (GetSpawnTile(spawn))
+    {
+        spawns.push_back(spawn);
+    }
+    LevelFile::Serialize(m_size, m_tileTypes, torches, spawns, data);
+}
 
-        file.close(); //closing the file
+// Builds the level from a binary level that has been checked.
+void Level::LoadLevel(const LevelFile& file)
+{
+    if (file.GetSize() != m_size)
+    {
+        Resize(file.GetSize());
+    }
 
-        // Create torches at specific locations.
-        sf::Vector2f locations[5];
-        locations[0] = GetActualTileLocation(3, 9);
-        locations[1] = GetActualTileLocation(7, 7);
-        locations[2] = GetActualTileLocation(11, 11);
-        locations[3] = GetActualTileLocation(13, 15);
-        locations[4] = GetActualTileLocation(15, 3);
+    const std::uint8_t* tiles = file.GetTiles();
+    for (size_t i = 0; i < m_tileTypes.size(); ++i)
+    {
+        m_tileTypes[i] = static_cast<TILE>(tiles[i]);
+    }
+    BuildBitboards();
 
-        // Spawn torches.
-        for (int i = 0; i < 5; ++i)
-        {
-            std::shared_ptr<Torch> torch = std::make_shared<Torch>();
-            torch->SetPosition(sf::Vector2f(static_cast<float>(locations[i].x), static_cast<float>(locations[i].y)));
-            m_torches.push_back(torch);
-        }
+    // Save the location of the exit door.
+    m_doorTiles.ForEach([this](int i, int j)
+    {
+        m_doorTileIndices = sf::Vector2i(i, j);
+    });
+
+    // The player starts on the first spawn tile, if the level has one. Otherwise the spawn location is put off the level.
+    sf::Vector2i spawn = (file.GetSpawnCount() > 0) ? file.GetSpawn(0) : sf::Vector2i(-1, -1);
+    m_spawnLocation = GetActualTileLocation(spawn.x, spawn.y);
 
-        m_reachableTiles = GetFloorLocations();
+    // Save where the torches go. They are created with the sprites, which tools and other headless loads never need.
+    m_torchLocations.clear();
+    for (int i = 0; i < file.GetTorchCount(); ++i)
+    {
+        sf::Vector2i torch = file.GetTorch(i);
+        m_torchLocations.push_back(GetActualTileLocation(torch.x, torch.y));
     }
-    else
+    m_tileSprites.clear();
+    m_torches.clear();
+
+    ResetLayoutRevision();
+}
+
+// Changes the number of columns and rows in the level, keeping it centred where it was.
+void Level::Resize(sf::Vector2i size)
+{
+    m_origin.x += ((m_size.x - size.x) * TILE_SIZE) / 2;
+    m_origin.y += ((m_size.y - size.y) * TILE_SIZE) / 2;
+    m_size = size;
+
+    m_grid.resize(m_size.x * m_size.y);
+    for (int i = 0; i < m_size.x; i++)
     {
-        return false;
+        for (int j = 0; j < m_size.y; j++)
+        {
+            auto cell = &m_grid[i * m_size.y + j];
+            cell->columnIndex = i;
+            cell->rowIndex = j;
+        }
     }
 
-    return true;
+    m_tileTypes.assign(m_size.x * m_size.y, TILE::EMPTY);
+    m_tileSprites.clear();
+    BuildBitboards();
 }
 
 // Checks if a given tile is a wall block.
 bool Level::IsWall(int i, int j)
 {
     if (TileIsValid(i, j))
-        return m_grid[i][j].type <= TILE::WALL_INTERSECTION;
+        return HasTileFlag(m_tileTypes[i * m_size.y + j], TILE_FLAG_WALL);
     else
         return false;
 }
@@ -283,21 +641,23 @@ bool Level::IsWall(int i, int j)
 // Unlocks the door in the level.
 void Level::UnlockDoor()
 {
-    SetTile(m_doorTileIndices.x, m_doorTileIndices.y, TILE::WALL_DOOR_UNLOCKED);
+    // Streamed floors, and levels loaded without a door, have no door to unlock, so the saved tile is only changed if it is one.
+    if ((TileIsValid(m_doorTileIndices.x, m_doorTileIndices.y)) && (GetTileType(m_doorTileIndices.x, m_doorTileIndices.y) == TILE::WALL_DOOR_LOCKED))
+    {
+        SetTile(m_doorTileIndices.x, m_doorTileIndices.y, TILE::WALL_DOOR_UNLOCKED);
+    }
 }
 
 // Return true if the given tile is a floor tile.
-bool Level::IsFloor(int columnIndex, int rowIndex)
+bool Level::IsFloor(int columnIndex, int rowIndex) const
 {
-    Tile* tile = &m_grid[columnIndex][rowIndex];
-
-    return ((tile->type == TILE::FLOOR) || (tile->type == TILE::FLOOR_ALT));
+    return HasTileFlag(m_tileTypes[columnIndex * m_size.y + rowIndex], TILE_FLAG_FLOOR);
 }
 
 // Return true if the given tile is a floor tile.
-bool Level::IsFloor(const Tile& tile)
+bool Level::IsFloor(const Tile& tile) const
 {
-    return ((tile.type == TILE::FLOOR) || (tile.type == TILE::FLOOR_ALT));
+    return IsFloor(tile.columnIndex, tile.rowIndex);
 }
 
 // Gets the size of the tiles in the level.
@@ -312,16 +672,19 @@ std::vector<std::shared_ptr<Torch>>* Level::GetTorches()
     return &m_torches;
 }
 
+// Gets where the torches in the level go.
+const std::vector<sf::Vector2f>& Level::GetTorchLocations() const
+{
+    return m_torchLocations;
+}
+
 // Draws the level grid to the given render window.
 void Level::Draw(sf::RenderWindow& window, float timeDelta)
 {
     // Draw the level tiles.
-    for (int i = 0; i < GRID_WIDTH; i++)
+    for (const sf::Sprite& sprite : m_tileSprites)
     {
-        for (int j = 0; j < GRID_HEIGHT; j++)
-        {
-            window.draw(m_grid[i][j].sprite);
-        }
+        window.draw(sprite);
     }
 
     // Draw all torches.
@@ -343,91 +706,86 @@ const sf::Vector2f Level::GetActualTileLocation(int columnIndex, int rowIndex) c
 // Get a vector with locations for all existing floor tiles on the level.
 std::vector<sf::Vector2f> Level::GetFloorLocations()
 {
-    std::vector<sf::Vector2f> available_locations = std::vector<sf::Vector2f>();
-    for (int i = 0; i < GRID_WIDTH; i++)
+    std::vector<sf::Vector2f> available_locations;
+    available_locations.reserve(m_walkableTiles.Count());
+    m_walkableTiles.ForEach([&](int i, int j)
     {
-        for (int j = 0; j < GRID_HEIGHT; j++)
-        {
-            Tile* cell = GetTile(i, j);
-            if (cell && IsFloor(i, j))
-            {
-                const sf::Vector2f location = GetActualTileLocation(i, j);
-                available_locations.push_back(location);
-            }
-        }
-    }
+        available_locations.push_back(GetActualTileLocation(i, j));
+    });
     return available_locations;
 }
 
 
 // Returns a valid spawn location from the currently loaded level.
-sf::Vector2f Level::GetRandomSpawnLocation()
+sf::Vector2f Level::GetRandomSpawnLocation(Random& random)
 {
-    // Select a random floor tile.
-    if (m_reachableTiles.size() == 0)
+    // Select a random tile that can be walked to from the spawn tile. A level without any floor can only spawn at the spawn location.
+    const std::vector<sf::Vector2f>& reachableTiles = GetReachableTiles();
+    if (reachableTiles.empty())
     {
-        m_reachableTiles = GetFloorLocations();
+        return m_spawnLocation;
     }
-    unsigned long index = std::rand() % m_reachableTiles.size();
-    sf::Vector2f tileLocation(m_reachableTiles[index]);
+    int index = random.Next(static_cast<int>(reachableTiles.size()));
+    sf::Vector2f tileLocation(reachableTiles[index]);
 
     // Create a random offset.
-    tileLocation.x += std::rand() % 15 - 10;
-    tileLocation.y += std::rand() % 15 - 10;
+    tileLocation.x += random.Next(15) - 10;
+    tileLocation.y += random.Next(15) - 10;
     return tileLocation;
 }
 
 // Sets the overlay color of the level tiles.
 void Level::SetColor(sf::Color tileColor)
 {
-    for (int i = 0; i < GRID_WIDTH; ++i)
+    m_tileColor = tileColor;
+    for (sf::Sprite& sprite : m_tileSprites)
     {
-        for (int j = 0; j < GRID_HEIGHT; ++j)
-        {
-            m_grid[i][j].sprite.setColor(tileColor);
-        }
+        sprite.setColor(tileColor);
     }
 }
 
-// Resets the A* data of all tiles.
-void Level::ResetNodes()
+// Generates the next room of the run.
+void Level::GenerateLevel()
 {
-    for(int i = 0; i < GRID_WIDTH; ++i)
-    {
-        for (int j = 0; j < GRID_WIDTH; ++j)
-        {
-            m_grid[i][j].parentNode = nullptr;
-            m_grid[i][j].G = 0;
-            m_grid[i][j].H = 0;
-            m_grid[i][j].F = 0;
-        }
-    }
+    GenerateLayout();
+    BindSprites();
 }
 
-// Generates a random level.
-void Level::GenerateLevel()
+// Generates the layout of the next room of the run.
+void Level::GenerateLayout()
 {
-    m_torches.clear();
-    m_reachableTiles.clear();
-    
+    // Increment our room/floor count, and seed the layout for the new room.
+    m_roomNumber++;
+    if (m_roomNumber == ROOMS_PER_FLOOR)
+    {
+        // Move to next floor.
+        m_roomNumber = 0;
+        m_floorNumber++;
+    }
+    m_random.Seed(Random::GetRoomSeed(m_seed, GetRoomIndex()), RANDOM_STREAM::LEVEL);
+
+    // Generate a random color for each new floor and apply it to the level tiles.
+    if (m_roomNumber == 0)
+    {
+        SetRandomColor();
+    }
+
+    m_torchLocations.clear();
+
     // Create the initial grid pattern.
-    for (int i = 0; i < GRID_WIDTH; ++i)
+    for (int i = 0; i < m_size.x; ++i)
     {
-        for (int j = 0; j < GRID_HEIGHT; ++j)
+        for (int j = 0; j < m_size.y; ++j)
         {
             if ((i % 2 != 0) && (j % 2 != 0))
             {
                 // Odd tiles, nothing.
-                m_grid[i][j].type = TILE::EMPTY;
+                m_tileTypes[i * m_size.y + j] = TILE::EMPTY;
             }
             else
             {
-                m_grid[i][j].type = TILE::WALL_TOP;
-                m_grid[i][j].sprite.setTexture(TextureManager::GetTexture(m_textureIDs[static_cast<int>(TILE::WALL_TOP)]));
+                m_tileTypes[i * m_size.y + j] = TILE::WALL_TOP;
             }
-
-            // Set the position.
-            m_grid[i][j].sprite.setPosition(m_origin.x + (TILE_SIZE * i), m_origin.y + (TILE_SIZE * j));
         }
     }
 
@@ -437,69 +795,178 @@ void Level::GenerateLevel()
     // Add some rooms to the level to create some open space.
     CreateRooms(ROOMS_COUNT);
 
-    // Set for each tile the correct texture.
+    // Set for each wall the correct type. The tiles were written directly, so the bitboards are built first.
+    BuildBitboards();
     CalculateTextures();
 
-    // Increment our room/floor count and generate new effect it necessary.
-    m_roomNumber++;
-    if (m_roomNumber == 5)
+    // Add entrance and exit tiles to the level.
+    GenerateEntryAndExit();
+
+    // Choose where the torches go.
+    GenerateTorches();
+
+    // Everything derived from the old layout is now out of date.
+    ResetLayoutRevision();
+}
+
+// Sets the sprite of every tile to match its type, and creates the torches.
+void Level::BindSprites()
+{
+    // Look each texture up once, rather than once per tile.
+    sf::Texture* textures[static_cast<int>(TILE::COUNT)];
+    for (int i = 0; i < static_cast<int>(TILE::COUNT); ++i)
     {
-        // Move to next floor.
-        m_roomNumber = 0;
-        m_floorNumber++;
+        textures[i] = &TextureManager::GetTexture(m_textureIDs[i]);
+    }
 
-        // Generate a random color and apply it to the level tiles.
-        SetRandomColor();
+    m_tileSprites.resize(m_tileTypes.size());
+    for (int i = 0; i < m_size.x; ++i)
+    {
+        for (int j = 0; j < m_size.y; ++j)
+        {
+            TILE type = m_tileTypes[i * m_size.y + j];
+            sf::Sprite& sprite = m_tileSprites[i * m_size.y + j];
+            if (type != TILE::EMPTY)
+            {
+                sprite.setTexture(*textures[static_cast<int>(type)]);
+            }
+            sprite.setPosition(m_origin.x + (TILE_SIZE * i), m_origin.y + (TILE_SIZE * j));
+            sprite.setColor(m_tileColor);
+        }
     }
 
-    // Add entrance and exit tiles to the level.
-    GenerateEntryAndExit();
+    // Each torch flickers with its own stream, so the flicker doesn't depend on anything else drawing numbers.
+    Random random(Random::GetRoomSeed(m_seed, GetRoomIndex()), RANDOM_STREAM::EFFECTS);
+    m_torches.clear();
+    for (const sf::Vector2f& location : m_torchLocations)
+    {
+        std::shared_ptr<Torch> torch = std::make_shared<Torch>(random.Next());
+        torch->SetPosition(location);
+        m_torches.push_back(torch);
+    }
+}
 
-    // Add torches to the level.
-    GenerateTorches();
+// Checks if the level has sprites or torches.
+bool Level::HasSprites() const
+{
+    return (!m_tileSprites.empty()) || (!m_torches.empty());
 }
 
-// Generate a randm path to the tile
-void Level::CreatePath(int columnIndex, int rowIndex)
+// Copies everything but the layout from another level.
+void Level::CopySettings(const Level& other)
+{
+    // The tiles are replaced by the next layout, so they are only copied when the grid is a different size.
+    if (m_size != other.m_size)
+    {
+        m_size = other.m_size;
+        m_grid = other.m_grid;
+        m_tileTypes.resize(other.m_tileTypes.size());
+    }
+
+    // The level may be the last room, handed back by ReplaceWith() with its sprites and torches still bound.
+    // Generating the layout would then set their textures and colors on the worker thread, racing the texture manager on the main thread.
+    m_tileSprites.clear();
+    m_torches.clear();
+
+    m_origin = other.m_origin;
+    m_seed = other.m_seed;
+    m_floorNumber = other.m_floorNumber;
+    m_roomNumber = other.m_roomNumber;
+    m_tileColor = other.m_tileColor;
+    std::copy(std::begin(other.m_textureIDs), std::end(other.m_textureIDs), std::begin(m_textureIDs));
+}
+
+// Replaces the level with another one.
+void Level::ReplaceWith(Level& other)
+{
+    std::swap(*this, other);
+
+    // Anything derived from the old level compares revisions, so the new ones must be later than any it has seen.
+    m_layoutRevision = std::max(m_layoutRevision, other.m_layoutRevision);
+    m_walkabilityRevision = std::max(m_walkabilityRevision, other.m_walkabilityRevision);
+    ResetLayoutRevision();
+}
+
+// Replaces the whole layout with the given tiles and moves the level to a new position.
+void Level::LoadLayout(sf::Vector2i position, const std::vector<TILE>& tiles, sf::Vector2f spawnLocation)
 {
-    // Store the current tile.
-    Tile* currentTile = &m_grid[columnIndex][rowIndex];
+    m_origin = position;
+    m_spawnLocation = spawnLocation;
+    std::copy(tiles.begin(), tiles.end(), m_tileTypes.begin());
+
+    m_torchLocations.clear();
+    BuildBitboards();
+    CalculateTextures();
+    ResetLayoutRevision();
 
-    // Create a list of possible directions and sort randomly.
-    sf::Vector2i directions[] = {{ 0, -2 }, { 2, 0 }, { 0, 2 }, { -2, 0 }};
-    std::random_shuffle(std::begin(directions), std::end(directions));
+    // The old sprites no longer match the tiles, and binding new ones is left to whoever draws the level.
+    m_tileSprites.clear();
+    m_torches.clear();
+}
 
-    // For each direction.
-    for (int i = 0; i < 4; i++)
+// Shuffles the maze directions with a Fisher-Yates shuffle.
+static void ShuffleDirections(Random& random, sf::Vector2i* directions, int count)
+{
+    for (int i = 1; i < count; ++i)
     {
-        // Get the new tile position.
-        int dx = currentTile->columnIndex + directions[i].x;
-        int dy = currentTile->rowIndex + directions[i].y;
+        int j = random.Next(i + 1);
+        if (i != j)
+        {
+            std::swap(directions[i], directions[j]);
+        }
+    }
+}
 
-        // If the tile is valid.
-        if (TileIsValid(dx, dy))
+// Generate a randm path to the tile
+void Level::CreatePath(int columnIndex, int rowIndex)
+{
+    // A tile on the path, with its directions in random order and the next one to try.
+    struct PathTile
+    {
+        Tile* tile;
+        sf::Vector2i directions[4];
+        int nextDirection;
+    };
+
+    // The tiles are kept on a stack instead of the call stack, so the depth isn't limited by the size of the level.
+    // They are visited in the same order as the recursive backtracker this replaces.
+    std::vector<PathTile> path;
+    path.reserve(((m_size.x / 2) * (m_size.y / 2)) + 1);
+    path.push_back({ &m_grid[columnIndex * m_size.y + rowIndex], {{ 0, -2 }, { 2, 0 }, { 0, 2 }, { -2, 0 }}, 0 });
+    ShuffleDirections(m_random, path.back().directions, 4);
+
+    while (!path.empty())
+    {
+        // Once every direction has been tried, backtrack.
+        PathTile& current = path.back();
+        if (current.nextDirection == 4)
         {
-            // Store the tile.
-            Tile* tile = &m_grid[dx][dy];
+            path.pop_back();
+            continue;
+        }
 
-            // If the tile has not yet been visited.
-            if (tile->type == TILE::EMPTY)
-            {
-                // Mark the tile as floor.
-                tile->type = TILE::FLOOR;
-                tile->sprite.setTexture(TextureManager::GetTexture(m_textureIDs[static_cast<int>(TILE::FLOOR)]));
+        // Get the new tile position.
+        Tile* currentTile = current.tile;
+        sf::Vector2i direction = current.directions[current.nextDirection++];
+        int dx = currentTile->columnIndex + direction.x;
+        int dy = currentTile->rowIndex + direction.y;
+
+        // If the tile is valid and has not yet been visited.
+        if (TileIsValid(dx, dy) && (m_tileTypes[dx * m_size.y + dy] == TILE::EMPTY))
+        {
+            // Mark the tile as floor.
+            Tile* tile = &m_grid[dx * m_size.y + dy];
+            m_tileTypes[dx * m_size.y + dy] = TILE::FLOOR;
 
-                // Knock that wall down.
-                int ddx = currentTile->columnIndex + (directions[i].x / 2);
-                int ddy = currentTile->rowIndex + (directions[i].y / 2);
+            // Knock that wall down.
+            int ddx = currentTile->columnIndex + (direction.x / 2);
+            int ddy = currentTile->rowIndex + (direction.y / 2);
 
-                Tile* wall = &m_grid[ddx][ddy];
-                wall->type = TILE::FLOOR;
-                wall->sprite.setTexture(TextureManager::GetTexture(m_textureIDs[static_cast<int>(TILE::FLOOR)]));
+            m_tileTypes[ddx * m_size.y + ddy] = TILE::FLOOR;
 
-                // Recursively call the function with the new tile.
-                CreatePath(dx, dy);
-            }
+            // Carry on from the new tile.
+            path.push_back({ tile, {{ 0, -2 }, { 2, 0 }, { 0, 2 }, { -2, 0 }}, 0 });
+            ShuffleDirections(m_random, path.back().directions, 4);
         }
     }
 }
@@ -510,12 +977,12 @@ void Level::CreateRooms(int roomCount)
     for (int i = 0; i < roomCount; ++i)
     {
         // Generate a room size.
-        int roomWidth = std::rand() % 2 + 1;
-        int roomHeight = std::rand() % 2 + 1;
+        int roomWidth = m_random.Next(2) + 1;
+        int roomHeight = m_random.Next(2) + 1;
 
         // Choose a random starting location.
-        int startI = std::rand() % (GRID_WIDTH - 2) + 1;
-        int startJ = std::rand() % (GRID_HEIGHT - 2) + 1;
+        int startI = m_random.Next(m_size.x - 2) + 1;
+        int startJ = m_random.Next(m_size.y - 2) + 1;
 
         for (int j = -1 ; j < roomHeight; ++j)
         {
@@ -526,70 +993,45 @@ void Level::CreateRooms(int roomCount)
 
                 // If passed not corner a tile, then convert it to the floor tile type.
                 if (TileIsValid(startI, startJ)
-                    && (newI != 0) && (newI != (GRID_WIDTH - 1))
-                    && (newJ != 0) && (newJ != (GRID_HEIGHT - 1)))
+                    && (newI != 0) && (newI != (m_size.x - 1))
+                    && (newJ != 0) && (newJ != (m_size.y - 1)))
                 {
-                    m_grid[newI][newJ].type = TILE::FLOOR;
-                    m_grid[newI][newJ].sprite.setTexture(TextureManager::GetTexture(m_textureIDs[static_cast<int>(TILE::FLOOR)]));
+                    m_tileTypes[newI * m_size.y + newJ] = TILE::FLOOR;
                 }
             }
         }
     }
 }
 
-// Calculates the correct texture for each tile in the level.
-void Level::CalculateTextures()
+// Calculates the correct wall type for each tile in the level.
+int Level::CalculateTextures()
 {
-    for (int i = 0; i < GRID_WIDTH; ++i)
+    // Only walls whose type changes need their sprite set again.
+    int changedCount = 0;
+    m_wallTiles.ForEachWithSides([&](int i, int j, int sides)
     {
-        for (int j = 0; j < GRID_HEIGHT; ++j)
+        TILE type = WALL_TYPES_BY_SIDES[sides];
+        int index = i * m_size.y + j;
+        if (m_tileTypes[index] != type)
         {
-            // If it is wall, then calculate bit mask and set a corresponding tile.
-            if (IsWall(i, j))
+            m_tileTypes[index] = type;
+            if (!m_tileSprites.empty())
             {
-                // Calculate bit mask.
-                int value = 0;
-
-                // Store the current type as default.
-                TILE type = m_grid[i][j].type;
-
-                // Top.
-                if (IsWall(i, j - 1))
-                {
-                    value += 1;
-                }
-                // Right.
-                if (IsWall(i + 1, j))
-                {
-                    value += 2;
-                }
-
-                // Bottom.
-                if (IsWall(i, j + 1))
-                {
-                    value += 4;
-                }
-
-                // Left.
-                if (IsWall(i - 1, j))
-                {
-                    value += 8;
-                }
-
-                // Set the new type.
-                m_grid[i][j].type = static_cast<TILE>(value);
-                m_grid[i][j].sprite.setTexture(TextureManager::GetTexture(m_textureIDs[value]));
+                m_tileSprites[index].setTexture(TextureManager::GetTexture(m_textureIDs[static_cast<int>(type)]));
             }
+            changedCount++;
         }
-    }
+    });
+
+    return changedCount;
 }
 
 // Set a random color for the level.
 void Level::SetRandomColor()
 {
-    sf::Uint8 r = std::rand() % 101 + 100;
-    sf::Uint8 g = std::rand() % 101 + 100;
-    sf::Uint8 b = std::rand() % 101 + 100;
+    sf::Uint8 r = m_random.Next(101) + 100;
+    sf::Uint8 g = m_random.Next(101) + 100;
+    sf::Uint8 b = m_random.Next(101) + 100;
     SetColor(sf::Color(r, g, b, 255));
 }
 
@@ -602,8 +1044,8 @@ void Level::GenerateEntryAndExit()
 
     while (startI == -1)
     {
-        int index = std::rand() % GRID_WIDTH;
-        if ((m_grid[index][GRID_HEIGHT - 1].type == TILE::WALL_TOP) && (index % 2 == 0))
+        int index = m_random.Next(m_size.x);
+        if ((m_tileTypes[index * m_size.y + (m_size.y - 1)] == TILE::WALL_TOP) && (index % 2 == 0))
         {
             startI = index;
         }
@@ -611,22 +1053,22 @@ void Level::GenerateEntryAndExit()
 
     while (endI == -1)
     {
-        int index = std::rand() % GRID_HEIGHT + 1;
-        if ((m_grid[index][0].type == TILE::WALL_TOP) && (index % 2 == 0))
+        int index = m_random.Next(m_size.x);
+        if ((m_tileTypes[index * m_size.y] == TILE::WALL_TOP) && (index % 2 == 0))
         {
             endI = index;
         }
     }
 
-    // Set the tile textures for the entrance and exit tiles.
-    SetTile(startI, GRID_HEIGHT - 1, TILE::WALL_ENTRANCE);
-    SetTile(endI, 0, TILE::WALL_DOOR_LOCKED);
+    // Set the entrance and exit tiles.
+    SetTileType(startI, m_size.y - 1, TILE::WALL_ENTRANCE);
+    SetTileType(endI, 0, TILE::WALL_DOOR_LOCKED);
 
     // Save the location of the exit door.
     m_doorTileIndices = sf::Vector2i(endI, 0);
 
     // Calculate the spawn location.
-    m_spawnLocation = GetActualTileLocation(startI, GRID_HEIGHT - 2);
+    m_spawnLocation = GetActualTileLocation(startI, m_size.y - 2);
 }
 
 // Returns the spawn location for the current level.
@@ -635,31 +1077,21 @@ sf::Vector2f Level::SpawnLocation()
     return m_spawnLocation;
 }
 
-// Generates an torches for the given level.
+// Chooses where the torches go in the given level.
 void Level::GenerateTorches()
 {
     // Get all wall tile positions.
     std::vector<sf::Vector2f> wall_positions;
-    for (int i = 0; i < GRID_WIDTH; ++i)
+    wall_positions.reserve(m_wallTiles.Count());
+    m_wallTiles.ForEach([&](int i, int j)
     {
-        for (int j = 0; j < GRID_HEIGHT; ++j)
-        {
-            if (IsWall(i, j))
-            {
-                sf::Vector2f position = GetActualTileLocation(i, j);
-                wall_positions.push_back(position);
-            }
-        }
-    }
+        wall_positions.push_back(GetActualTileLocation(i, j));
+    });
 
     // Set a unique position for each torch.
     for (int i = 0; i < TORCHES_COUNT; ++i)
     {
-        unsigned long index = std::rand() % wall_positions.size();
-        sf::Vector2f position(wall_positions[index]);
-
-        std::shared_ptr<Torch> torch = std::make_shared<Torch>();
-        torch->SetPosition(position);
-        m_torches.push_back(torch);
+        int index = m_random.Next(static_cast<int>(wall_positions.size()));
+        m_torchLocations.push_back(wall_positions[index]);
     }
 }
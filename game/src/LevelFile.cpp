@@ -0,0 +1,328 @@
+#include <cstring>
+#include "PCH.h"
+#include "LevelFile.h"
+
+// The tiles that the text level loader always put torches on, since the text format has no way to place them.
+static sf::Vector2i const TEXT_LEVEL_TORCHES[] = { { 3, 9 }, { 7, 7 }, { 11, 11 }, { 13, 15 }, { 15, 3 } };
+
+// The size of each entry of the torch and spawn tables in bytes.
+static size_t const LEVEL_FILE_LOCATION_SIZE = 2 * sizeof(std::int32_t);
+
+
+// Rounds a number of bytes up to the next multiple of 4, so the tables after the tiles are aligned.
+static size_t AlignTables(size_t size)
+{
+    return (size + 3) & ~static_cast<size_t>(3);
+}
+
+// Default constructor.
+LevelFile::LevelFile() :
+m_header(),
+m_tiles(nullptr),
+m_torches(nullptr),
+m_spawns(nullptr)
+{
+}
+
+// Maps a binary level file and checks it.
+bool LevelFile::Open(const std::string& fileName)
+{
+    if (!m_file.Open(fileName))
+    {
+        return false;
+    }
+
+    if (!Read(m_file.GetData(), m_file.GetSize()))
+    {
+        m_file.Close();
+        return false;
+    }
+
+    return true;
+}
+
+// Checks a binary level held in memory.
+bool LevelFile::Read(const unsigned char* data, size_t size)
+{
+    m_tiles = nullptr;
+    m_torches = nullptr;
+    m_spawns = nullptr;
+
+    // The header is copied out, since the data may not be aligned.
+    if (size < sizeof(LevelFileHeader))
+    {
+        return false;
+    }
+    std::memcpy(&m_header, data, sizeof(LevelFileHeader));
+
+    if ((std::memcmp(m_header.magic, LEVEL_FILE_MAGIC, sizeof(LEVEL_FILE_MAGIC)) != 0) || (m_header.version != LEVEL_FILE_VERSION))
+    {
+        return false;
+    }
+
+    if ((m_header.columnCount == 0) || (m_header.columnCount > LEVEL_FILE_MAX_SIZE) || (m_header.rowCount == 0) || (m_header.rowCount > LEVEL_FILE_MAX_SIZE))
+    {
+        return false;
+    }
+
+    // The tables can't hold more entries than the file has room for, which also keeps the sizes below from overflowing.
+    size_t tileBytes = AlignTables(static_cast<size_t>(m_header.columnCount) * m_header.rowCount);
+    size_t maxLocationCount = size / LEVEL_FILE_LOCATION_SIZE;
+    if ((m_header.torchCount > maxLocationCount) || (m_header.spawnCount > maxLocationCount))
+    {
+        return false;
+    }
+
+    size_t expectedSize = sizeof(LevelFileHeader) + tileBytes + (static_cast<size_t>(m_header.torchCount) + m_header.spawnCount) * LEVEL_FILE_LOCATION_SIZE;
+    if (size != expectedSize)
+    {
+        return false;
+    }
+
+    if (CalculateChecksum(data + sizeof(LevelFileHeader), size - sizeof(LevelFileHeader)) != m_header.checksum)
+    {
+        return false;
+    }
+
+    // Every tile must be a real type, since they are used as TILE values without any more checks.
+    const std::uint8_t* tiles = data + sizeof(LevelFileHeader);
+    size_t tileCount = static_cast<size_t>(m_header.columnCount) * m_header.rowCount;
+    for (size_t i = 0; i < tileCount; ++i)
+    {
+        if (tiles[i] >= static_cast<std::uint8_t>(TILE::COUNT))
+        {
+            return false;
+        }
+    }
+
+    m_tiles = tiles;
+    m_torches = tiles + tileBytes;
+    m_spawns = m_torches + m_header.torchCount * LEVEL_FILE_LOCATION_SIZE;
+
+    // Torches and spawns must be on the level.
+    for (int i = 0; i < GetTorchCount(); ++i)
+    {
+        sf::Vector2i torch = GetTorch(i);
+        if ((torch.x < 0) || (torch.x >= GetSize().x) || (torch.y < 0) || (torch.y >= GetSize().y))
+        {
+            m_tiles = nullptr;
+            return false;
+        }
+    }
+    for (int i = 0; i < GetSpawnCount(); ++i)
+    {
+        sf::Vector2i spawn = GetSpawn(i);
+        if ((spawn.x < 0) || (spawn.x >= GetSize().x) || (spawn.y < 0) || (spawn.y >= GetSize().y))
+        {
+            m_tiles = nullptr;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Gets the size of the level.
+sf::Vector2i LevelFile::GetSize() const
+{
+    return { static_cast<int>(m_header.columnCount), static_cast<int>(m_header.rowCount) };
+}
+
+// Gets the tiles of the level.
+const std::uint8_t* LevelFile::GetTiles() const
+{
+    return m_tiles;
+}
+
+// Gets the number of torches in the level.
+int LevelFile::GetTorchCount() const
+{
+    return static_cast<int>(m_header.torchCount);
+}
+
+// Gets the tile that a torch is on.
+sf::Vector2i LevelFile::GetTorch(int index) const
+{
+    return ReadLocation(m_torches, index);
+}
+
+// Gets the number of player spawn tiles in the level.
+int LevelFile::GetSpawnCount() const
+{
+    return static_cast<int>(m_header.spawnCount);
+}
+
+// Gets a tile that the player can spawn on.
+sf::Vector2i LevelFile::GetSpawn(int index) const
+{
+    return ReadLocation(m_spawns, index);
+}
+
+// Builds a binary level.
+void LevelFile::Serialize(sf::Vector2i size, const std::vector<TILE>& tiles, const std::vector<sf::Vector2i>& torches, const std::vector<sf::Vector2i>& spawns, std::vector<unsigned char>& data)
+{
+    size_t tileBytes = AlignTables(tiles.size());
+    data.assign(sizeof(LevelFileHeader) + tileBytes + (torches.size() + spawns.size()) * LEVEL_FILE_LOCATION_SIZE, 0);
+
+    unsigned char* tileData = data.data() + sizeof(LevelFileHeader);
+    for (size_t i = 0; i < tiles.size(); ++i)
+    {
+        tileData[i] = static_cast<unsigned char>(tiles[i]);
+    }
+
+    unsigned char* location = tileData + tileBytes;
+    for (const std::vector<sf::Vector2i>* table : { &torches, &spawns })
+    {
+        for (const sf::Vector2i& tile : *table)
+        {
+            std::int32_t values[2] = { tile.x, tile.y };
+            std::memcpy(location, values, LEVEL_FILE_LOCATION_SIZE);
+            location += LEVEL_FILE_LOCATION_SIZE;
+        }
+    }
+
+    LevelFileHeader header;
+    std::memcpy(header.magic, LEVEL_FILE_MAGIC, sizeof(LEVEL_FILE_MAGIC));
+    header.version = LEVEL_FILE_VERSION;
+    header.columnCount = static_cast<std::uint32_t>(size.x);
+    header.rowCount = static_cast<std::uint32_t>(size.y);
+    header.torchCount = static_cast<std::uint32_t>(torches.size());
+    header.spawnCount = static_cast<std::uint32_t>(spawns.size());
+    header.checksum = CalculateChecksum(tileData, data.size() - sizeof(LevelFileHeader));
+    header.reserved = 0;
+    std::memcpy(data.data(), &header, sizeof(LevelFileHeader));
+}
+
+// Writes a binary level file.
+bool LevelFile::Write(const std::string& fileName, sf::Vector2i size, const std::vector<TILE>& tiles, const std::vector<sf::Vector2i>& torches, const std::vector<sf::Vector2i>& spawns)
+{
+    std::vector<unsigned char> data;
+    Serialize(size, tiles, torches, spawns, data);
+
+    std::ofstream file(fileName, std::ios::binary);
+    file.write(reinterpret_cast<const char*>(data.data()), data.size());
+    return static_cast<bool>(file);
+}
+
+// Reads a level in the old text format.
+bool LevelFile::ReadTextLevel(const std::string& fileName, sf::Vector2i& size, std::vector<TILE>& tiles)
+{
+    std::ifstream file(fileName);
+    if (!file.is_open())
+    {
+        return false;
+    }
+
+    // Read the rows first, since the tiles are stored a column at a time.
+    std::vector<std::vector<TILE>> rows;
+    std::string line;
+    while (std::getline(file, line))
+    {
+        std::vector<TILE> row;
+        for (size_t start = line.find('['); start != std::string::npos; start = line.find('[', start + 1))
+        {
+            size_t end = line.find(']', start);
+            if ((end == std::string::npos) || (end == start + 1))
+            {
+                return false;
+            }
+
+            int tileID = 0;
+            for (size_t i = start + 1; i < end; ++i)
+            {
+                if ((line[i] < '0') || (line[i] > '9') || (tileID >= static_cast<int>(TILE::COUNT)))
+                {
+                    return false;
+                }
+                tileID = tileID * 10 + (line[i] - '0');
+            }
+            if (tileID >= static_cast<int>(TILE::COUNT))
+            {
+                return false;
+            }
+            row.push_back(static_cast<TILE>(tileID));
+        }
+
+        // Blank lines, such as one at the end of the file, are skipped. Every other row must be as long as the first.
+        if (row.empty())
+        {
+            continue;
+        }
+        if ((!rows.empty()) && (row.size() != rows.front().size()))
+        {
+            return false;
+        }
+        rows.push_back(std::move(row));
+    }
+
+    if ((rows.empty()) || (rows.size() > LEVEL_FILE_MAX_SIZE) || (rows.front().size() > LEVEL_FILE_MAX_SIZE))
+    {
+        return false;
+    }
+
+    size = sf::Vector2i(static_cast<int>(rows.front().size()), static_cast<int>(rows.size()));
+    tiles.resize(size.x * size.y);
+    for (int i = 0; i < size.x; ++i)
+    {
+        for (int j = 0; j < size.y; ++j)
+        {
+            tiles[i * size.y + j] = rows[j][i];
+        }
+    }
+
+    return true;
+}
+
+// Converts a level in the old text format to a binary level file.
+bool LevelFile::ConvertTextLevel(const std::string& textFileName, const std::string& fileName)
+{
+    sf::Vector2i size;
+    std::vector<TILE> tiles;
+    if (!ReadTextLevel(textFileName, size, tiles))
+    {
+        return false;
+    }
+
+    std::vector<sf::Vector2i> torches;
+    for (const sf::Vector2i& torch : TEXT_LEVEL_TORCHES)
+    {
+        if ((torch.x < size.x) && (torch.y < size.y))
+        {
+            torches.push_back(torch);
+        }
+    }
+
+    // The player spawns on the tile in front of the entrance, which is in the bottom wall in a generated level.
+    std::vector<sf::Vector2i> spawns;
+    for (int i = 0; i < size.x; ++i)
+    {
+        for (int j = 1; j < size.y; ++j)
+        {
+            if (tiles[i * size.y + j] == TILE::WALL_ENTRANCE)
+            {
+                spawns.push_back(sf::Vector2i(i, j - 1));
+            }
+        }
+    }
+
+    return Write(fileName, size, tiles, torches, spawns);
+}
+
+// Calculates the checksum that binary levels use.
+std::uint32_t LevelFile::CalculateChecksum(const unsigned char* data, size_t size)
+{
+    std::uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash = (hash ^ data[i]) * 16777619u;
+    }
+    return hash;
+}
+
+// Reads one entry of the torch or spawn table.
+sf::Vector2i LevelFile::ReadLocation(const unsigned char* table, int index)
+{
+    std::int32_t values[2];
+    std::memcpy(values, table + index * LEVEL_FILE_LOCATION_SIZE, LEVEL_FILE_LOCATION_SIZE);
+    return { values[0], values[1] };
+}
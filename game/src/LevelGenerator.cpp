@@ -0,0 +1,108 @@
+#include <cassert>
+#include <chrono>
+#include "PCH.h"
+#include "LevelGenerator.h"
+
+// Default constructor.
+LevelGenerator::LevelGenerator() :
+m_generationTime(0),
+m_finishTime(0)
+{
+}
+
+// Destructor.
+LevelGenerator::~LevelGenerator()
+{
+    Cancel();
+}
+
+// Starts generating the room after the given one on a background thread.
+void LevelGenerator::Start(const Level& level)
+{
+    Cancel();
+    m_level.CopySettings(level);
+
+    // Nothing on the worker thread may touch a texture, so the level must have no sprites for GenerateLayout() to set.
+    assert(!m_level.HasSprites());
+
+    m_thread = std::thread([this]
+    {
+        auto generationStart = std::chrono::steady_clock::now();
+        m_level.GenerateLayout();
+        PlanSpawns(m_level, m_spawnPlan);
+        m_generationTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - generationStart).count();
+    });
+}
+
+// Waits for a background generation to finish, and throws away the room it made.
+void LevelGenerator::Cancel()
+{
+    if (m_thread.joinable())
+    {
+        m_thread.join();
+    }
+}
+
+// Checks if a room has been started and not yet taken.
+bool LevelGenerator::IsStarted() const
+{
+    return m_thread.joinable();
+}
+
+// Swaps the generated room into a level.
+void LevelGenerator::Finish(Level& level, SpawnPlan& spawnPlan)
+{
+    auto finishStart = std::chrono::steady_clock::now();
+
+    m_thread.join();
+    level.ReplaceWith(m_level);
+    level.BindSprites();
+    std::swap(spawnPlan, m_spawnPlan);
+
+    m_finishTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - finishStart).count();
+}
+
+// Gets the time the last background generation took.
+long long LevelGenerator::GetGenerationTime() const
+{
+    return m_generationTime;
+}
+
+// Gets the time the last call to Finish() took.
+long long LevelGenerator::GetFinishTime() const
+{
+    return m_finishTime;
+}
+
+// Chooses the items and enemies to spawn in a level.
+void LevelGenerator::PlanSpawns(Level& level, SpawnPlan& spawnPlan)
+{
+    spawnPlan.items.clear();
+    spawnPlan.enemies.clear();
+
+    // The spawns have their own stream, so they are the same whichever order the room is generated and bound in.
+    Random random(Random::GetRoomSeed(level.GetSeed(), level.GetRoomIndex()), RANDOM_STREAM::SPAWNS);
+
+    // Every room has a key.
+    spawnPlan.keyLocation = level.GetRandomSpawnLocation(random);
+
+    for (int i = 0; i < MAX_ITEM_SPAWN_COUNT; i++)
+    {
+        if (random.Next(2))
+        {
+            // Choose a random item type, other than a key.
+            ITEM itemType = static_cast<ITEM>(random.Next(static_cast<int>(ITEM::COUNT) - 1));
+            spawnPlan.items.push_back({ itemType, level.GetRandomSpawnLocation(random) });
+        }
+    }
+
+    for (int i = 0; i < MAX_ENEMY_SPAWN_COUNT; i++)
+    {
+        if (random.Next(2))
+        {
+            // Choose a random enemy type.
+            ENEMY enemyType = static_cast<ENEMY>(random.Next(static_cast<int>(ENEMY::COUNT)));
+            spawnPlan.enemies.push_back({ enemyType, level.GetRandomSpawnLocation(random) });
+        }
+    }
+}
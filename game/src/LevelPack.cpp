@@ -0,0 +1,145 @@
+#include <cstring>
+#include "PCH.h"
+#include "LevelPack.h"
+
+// Rounds a number of bytes up to the next multiple of 8, so every level starts aligned.
+static size_t AlignLevel(size_t size)
+{
+    return (size + 7) & ~static_cast<size_t>(7);
+}
+
+// Reads one entry of the index.
+static LevelPackEntry ReadEntry(const unsigned char* index, int levelID)
+{
+    LevelPackEntry entry;
+    std::memcpy(&entry, index + levelID * sizeof(LevelPackEntry), sizeof(LevelPackEntry));
+    return entry;
+}
+
+
+// Default constructor.
+LevelPack::LevelPack() :
+m_levelCount(0),
+m_index(nullptr)
+{
+}
+
+// Maps a level pack and checks its index.
+bool LevelPack::Open(const std::string& fileName)
+{
+    m_levelCount = 0;
+    m_index = nullptr;
+
+    if (!m_file.Open(fileName))
+    {
+        return false;
+    }
+
+    const unsigned char* data = m_file.GetData();
+    size_t size = m_file.GetSize();
+
+    LevelPackHeader header;
+    if (size < sizeof(LevelPackHeader))
+    {
+        m_file.Close();
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(LevelPackHeader));
+
+    // The index can't hold more entries than the file has room for, which also keeps its size from overflowing.
+    if ((std::memcmp(header.magic, LEVEL_PACK_MAGIC, sizeof(LEVEL_PACK_MAGIC)) != 0) || (header.version != LEVEL_PACK_VERSION)
+        || (header.levelCount > (size - sizeof(LevelPackHeader)) / sizeof(LevelPackEntry)))
+    {
+        m_file.Close();
+        return false;
+    }
+
+    const unsigned char* index = data + sizeof(LevelPackHeader);
+    size_t indexEnd = sizeof(LevelPackHeader) + header.levelCount * sizeof(LevelPackEntry);
+    if (LevelFile::CalculateChecksum(index, indexEnd - sizeof(LevelPackHeader)) != header.checksum)
+    {
+        m_file.Close();
+        return false;
+    }
+
+    // Every level must lie after the index and inside the file, so fetching one never needs a bounds check on the pack.
+    for (std::uint32_t i = 0; i < header.levelCount; ++i)
+    {
+        LevelPackEntry entry = ReadEntry(index, static_cast<int>(i));
+        if ((entry.offset < indexEnd) || (entry.offset > size) || (entry.size > size - entry.offset))
+        {
+            m_file.Close();
+            return false;
+        }
+    }
+
+    m_levelCount = static_cast<int>(header.levelCount);
+    m_index = index;
+    return true;
+}
+
+// Gets the number of levels in the pack.
+int LevelPack::GetLevelCount() const
+{
+    return m_levelCount;
+}
+
+// Fetches a level from the pack.
+bool LevelPack::GetLevel(int levelID, LevelFile& level) const
+{
+    if ((levelID < 0) || (levelID >= m_levelCount))
+    {
+        return false;
+    }
+
+    LevelPackEntry entry = ReadEntry(m_index, levelID);
+    return level.Read(m_file.GetData() + entry.offset, entry.size);
+}
+
+// Builds a level pack.
+void LevelPack::Serialize(const std::vector<std::vector<unsigned char>>& levels, std::vector<unsigned char>& data)
+{
+    size_t indexEnd = sizeof(LevelPackHeader) + levels.size() * sizeof(LevelPackEntry);
+    size_t size = AlignLevel(indexEnd);
+    for (const std::vector<unsigned char>& level : levels)
+    {
+        size = AlignLevel(size + level.size());
+    }
+    data.assign(size, 0);
+
+    // Write each level and its index entry.
+    unsigned char* index = data.data() + sizeof(LevelPackHeader);
+    size_t offset = AlignLevel(indexEnd);
+    for (size_t i = 0; i < levels.size(); ++i)
+    {
+        LevelPackEntry entry;
+        entry.offset = offset;
+        entry.size = static_cast<std::uint32_t>(levels[i].size());
+        entry.reserved = 0;
+        std::memcpy(index + i * sizeof(LevelPackEntry), &entry, sizeof(LevelPackEntry));
+
+        if (!levels[i].empty())
+        {
+            std::memcpy(data.data() + offset, levels[i].data(), levels[i].size());
+        }
+        offset = AlignLevel(offset + levels[i].size());
+    }
+
+    LevelPackHeader header;
+    std::memcpy(header.magic, LEVEL_PACK_MAGIC, sizeof(LEVEL_PACK_MAGIC));
+    header.version = LEVEL_PACK_VERSION;
+    header.levelCount = static_cast<std::uint32_t>(levels.size());
+    header.checksum = LevelFile::CalculateChecksum(index, indexEnd - sizeof(LevelPackHeader));
+    std::memcpy(data.data(), &header, sizeof(LevelPackHeader));
+}
+
+// Writes a level pack file.
+bool LevelPack::Write(const std::string& fileName, const std::vector<std::vector<unsigned char>>& levels)
+{
+    std::vector<unsigned char> data;
+    Serialize(levels, data);
+
+    std::ofstream file(fileName, std::ios::binary);
+    file.write(reinterpret_cast<const char*>(data.data()), data.size());
+    return static_cast<bool>(file);
+}
@@ -0,0 +1,294 @@
+#include <cmath>
+#include <cstdlib>
+#include "PCH.h"
+#include "LevelStreamer.h"
+
+// The longest run of tiles that one serialized run can hold.
+static int const CHUNK_MAX_RUN_LENGTH = 255;
+
+// Default constructor.
+LevelStreamer::LevelStreamer() :
+m_seed(0),
+m_isStreaming(false),
+m_centerChunk({ 0, 0 }),
+m_storeCount(0),
+m_storedByteCount(0)
+{
+}
+
+// Gets the size of the level that the chunks in range are streamed into.
+sf::Vector2i LevelStreamer::GetLevelSize()
+{
+    // A ring of wall around the chunks stops anything leaving the level through the gaps at their edges.
+    // It is rounded up to an odd size like a generated level.
+    int size = ((((CHUNK_RADIUS * 2) + 1) * CHUNK_SIZE) + 2) | 1;
+    return { size, size };
+}
+
+// Gets the position that a run on an endless floor starts from.
+sf::Vector2f LevelStreamer::GetStartLocation()
+{
+    // Odd tiles are maze cells, which are always floor.
+    return { TILE_SIZE * 1.5f, TILE_SIZE * 1.5f };
+}
+
+// Forgets every chunk and starts a new endless floor.
+void LevelStreamer::Reset(std::uint64_t seed)
+{
+    m_seed = seed;
+    m_isStreaming = false;
+    m_storedChunks.clear();
+    m_storedByteCount = 0;
+}
+
+// Streams the chunks around a position into a level, if the position has moved into another chunk.
+bool LevelStreamer::Update(Level& level, sf::Vector2f position)
+{
+    sf::Vector2i centerChunk = GetChunk(position);
+    if ((m_isStreaming) && (centerChunk == m_centerChunk))
+    {
+        return false;
+    }
+
+    sf::Vector2i size = level.GetSize();
+    int chunkCount = (CHUNK_RADIUS * 2) + 1;
+    sf::Vector2i oldFirstChunk(m_centerChunk.x - CHUNK_RADIUS, m_centerChunk.y - CHUNK_RADIUS);
+    sf::Vector2i firstChunk(centerChunk.x - CHUNK_RADIUS, centerChunk.y - CHUNK_RADIUS);
+    TILE chunkTiles[CHUNK_SIZE * CHUNK_SIZE];
+
+    // Serialize the chunks that have gone out of range.
+    if (m_isStreaming)
+    {
+        for (int i = 0; i < chunkCount; ++i)
+        {
+            for (int j = 0; j < chunkCount; ++j)
+            {
+                sf::Vector2i chunk(oldFirstChunk.x + i, oldFirstChunk.y + j);
+                if ((std::abs(chunk.x - centerChunk.x) <= CHUNK_RADIUS) && (std::abs(chunk.y - centerChunk.y) <= CHUNK_RADIUS))
+                {
+                    continue;
+                }
+
+                for (int x = 0; x < CHUNK_SIZE; ++x)
+                {
+                    for (int y = 0; y < CHUNK_SIZE; ++y)
+                    {
+                        chunkTiles[x * CHUNK_SIZE + y] = level.GetTileType(i * CHUNK_SIZE + x + 1, j * CHUNK_SIZE + y + 1);
+                    }
+                }
+                SaveChunk(chunk, chunkTiles);
+            }
+        }
+    }
+
+    // Fill the new layout, keeping the chunks that are still in range and loading or generating the rest.
+    // Chunk tiles are offset by one for the ring of wall around them.
+    std::vector<TILE> tiles(size.x * size.y, TILE::WALL_TOP);
+    for (int i = 0; i < chunkCount; ++i)
+    {
+        for (int j = 0; j < chunkCount; ++j)
+        {
+            sf::Vector2i chunk(firstChunk.x + i, firstChunk.y + j);
+            sf::Vector2i oldIndex(chunk.x - oldFirstChunk.x, chunk.y - oldFirstChunk.y);
+            bool isResident = (m_isStreaming) && (oldIndex.x >= 0) && (oldIndex.x < chunkCount) && (oldIndex.y >= 0) && (oldIndex.y < chunkCount);
+
+            if (isResident)
+            {
+                for (int x = 0; x < CHUNK_SIZE; ++x)
+                {
+                    for (int y = 0; y < CHUNK_SIZE; ++y)
+                    {
+                        chunkTiles[x * CHUNK_SIZE + y] = level.GetTileType(oldIndex.x * CHUNK_SIZE + x + 1, oldIndex.y * CHUNK_SIZE + y + 1);
+                    }
+                }
+            }
+            else if (!LoadChunk(chunk, chunkTiles))
+            {
+                GenerateChunk(chunk, chunkTiles);
+            }
+
+            for (int x = 0; x < CHUNK_SIZE; ++x)
+            {
+                for (int y = 0; y < CHUNK_SIZE; ++y)
+                {
+                    tiles[(i * CHUNK_SIZE + x + 1) * size.y + (j * CHUNK_SIZE + y + 1)] = chunkTiles[x * CHUNK_SIZE + y];
+                }
+            }
+        }
+    }
+
+    // The chunks start one tile in, inside the ring of wall. Anything spawned has to be reachable from where the player is now.
+    level.LoadLayout(sf::Vector2i((firstChunk.x * CHUNK_SIZE - 1) * TILE_SIZE, (firstChunk.y * CHUNK_SIZE - 1) * TILE_SIZE), tiles, position);
+    m_centerChunk = centerChunk;
+    m_isStreaming = true;
+    return true;
+}
+
+// Gets the number of chunks held in serialized form.
+int LevelStreamer::GetStoredChunkCount() const
+{
+    return static_cast<int>(m_storedChunks.size());
+}
+
+// Gets the memory used by the serialized chunks.
+size_t LevelStreamer::GetStoredByteCount() const
+{
+    return m_storedByteCount;
+}
+
+// Gets the chunk that a position lies in.
+sf::Vector2i LevelStreamer::GetChunk(sf::Vector2f position)
+{
+    float chunkWidth = static_cast<float>(CHUNK_SIZE * TILE_SIZE);
+    return { static_cast<int>(std::floor(position.x / chunkWidth)), static_cast<int>(std::floor(position.y / chunkWidth)) };
+}
+
+// Gets the key that a chunk is stored under.
+std::uint64_t LevelStreamer::GetChunkKey(sf::Vector2i chunk)
+{
+    // The coordinates are reinterpreted as unsigned first, so negative chunks never shift a negative value.
+    return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(chunk.x)) << 32) | static_cast<std::uint32_t>(chunk.y);
+}
+
+// Generates the layout of a chunk from the seed.
+void LevelStreamer::GenerateChunk(sf::Vector2i chunk, TILE* tiles) const
+{
+    Random random(Random::GetRoomSeed(Random::GetRoomSeed(m_seed, chunk.x), chunk.y), RANDOM_STREAM::LEVEL);
+
+    // Odd tiles are the cells of the maze, and everything else starts as wall.
+    for (int x = 0; x < CHUNK_SIZE; ++x)
+    {
+        for (int y = 0; y < CHUNK_SIZE; ++y)
+        {
+            tiles[x * CHUNK_SIZE + y] = ((x % 2 != 0) && (y % 2 != 0)) ? TILE::FLOOR : TILE::WALL_TOP;
+        }
+    }
+
+    // Carve a maze through the cells with a randomized depth first search.
+    int const cellCount = CHUNK_SIZE / 2;
+    sf::Vector2i const directions[] = { { 0, -1 }, { 1, 0 }, { 0, 1 }, { -1, 0 } };
+    std::vector<bool> visited(cellCount * cellCount, false);
+    std::vector<sf::Vector2i> path;
+    path.reserve(cellCount * cellCount);
+    int startColumn = random.Next(cellCount);
+    int startRow = random.Next(cellCount);
+    path.push_back({ startColumn, startRow });
+    visited[startColumn * cellCount + startRow] = true;
+
+    while (!path.empty())
+    {
+        sf::Vector2i cell = path.back();
+        sf::Vector2i neighbors[4];
+        int neighborCount = 0;
+        for (const sf::Vector2i& direction : directions)
+        {
+            sf::Vector2i neighbor(cell.x + direction.x, cell.y + direction.y);
+            if ((neighbor.x >= 0) && (neighbor.x < cellCount) && (neighbor.y >= 0) && (neighbor.y < cellCount) && (!visited[neighbor.x * cellCount + neighbor.y]))
+            {
+                neighbors[neighborCount++] = neighbor;
+            }
+        }
+
+        if (neighborCount == 0)
+        {
+            path.pop_back();
+            continue;
+        }
+
+        // Knock down the wall between the cells, which sits between their tiles.
+        sf::Vector2i next = neighbors[random.Next(neighborCount)];
+        tiles[(cell.x + next.x + 1) * CHUNK_SIZE + (cell.y + next.y + 1)] = TILE::FLOOR;
+        visited[next.x * cellCount + next.y] = true;
+        path.push_back(next);
+    }
+
+    // Open some extra walls inside the chunk.
+    for (int i = 0; i < CHUNK_EXTRA_OPENINGS; ++i)
+    {
+        if (random.Next(2))
+        {
+            // The wall to the east of a cell.
+            int column = random.Next(cellCount - 1);
+            int row = random.Next(cellCount);
+            tiles[(column * 2 + 2) * CHUNK_SIZE + (row * 2 + 1)] = TILE::FLOOR;
+        }
+        else
+        {
+            // The wall to the south of a cell.
+            int column = random.Next(cellCount);
+            int row = random.Next(cellCount - 1);
+            tiles[(column * 2 + 1) * CHUNK_SIZE + (row * 2 + 2)] = TILE::FLOOR;
+        }
+    }
+
+    // Open gaps to the chunks to the west and north. Their own gaps join this chunk to the chunks beyond them, so every chunk is reachable.
+    for (int i = 0; i < CHUNK_EDGE_OPENINGS; ++i)
+    {
+        tiles[random.Next(cellCount) * 2 + 1] = TILE::FLOOR;
+        tiles[(random.Next(cellCount) * 2 + 1) * CHUNK_SIZE] = TILE::FLOOR;
+    }
+}
+
+// Serializes a chunk that has gone out of range.
+void LevelStreamer::SaveChunk(sf::Vector2i chunk, const TILE* tiles)
+{
+    if (static_cast<int>(m_storedChunks.size()) >= MAX_STORED_CHUNKS)
+    {
+        // Drop the chunk that has been stored the longest. It can still be generated again from the seed.
+        auto oldest = m_storedChunks.begin();
+        for (auto it = m_storedChunks.begin(); it != m_storedChunks.end(); ++it)
+        {
+            if (it->second.storeTime < oldest->second.storeTime)
+            {
+                oldest = it;
+            }
+        }
+        m_storedByteCount -= oldest->second.runs.size();
+        m_storedChunks.erase(oldest);
+    }
+
+    // Store the tiles as runs of the same type. Wall types depend on their neighbours and are worked out again when loaded, so walls are all stored as one type.
+    StoredChunk storedChunk;
+    storedChunk.storeTime = m_storeCount++;
+    for (int i = 0; i < CHUNK_SIZE * CHUNK_SIZE;)
+    {
+        TILE type = (tiles[i] <= TILE::WALL_INTERSECTION) ? TILE::WALL_TOP : tiles[i];
+        int length = 1;
+        while ((i + length < CHUNK_SIZE * CHUNK_SIZE) && (length < CHUNK_MAX_RUN_LENGTH) && (((tiles[i + length] <= TILE::WALL_INTERSECTION) ? TILE::WALL_TOP : tiles[i + length]) == type))
+        {
+            length++;
+        }
+
+        storedChunk.runs.push_back(static_cast<unsigned char>(length));
+        storedChunk.runs.push_back(static_cast<unsigned char>(type));
+        i += length;
+    }
+    storedChunk.runs.shrink_to_fit();
+
+    m_storedByteCount += storedChunk.runs.size();
+    m_storedChunks[GetChunkKey(chunk)] = std::move(storedChunk);
+}
+
+// Takes a chunk out of the store.
+bool LevelStreamer::LoadChunk(sf::Vector2i chunk, TILE* tiles)
+{
+    auto storedChunk = m_storedChunks.find(GetChunkKey(chunk));
+    if (storedChunk == m_storedChunks.end())
+    {
+        return false;
+    }
+
+    const std::vector<unsigned char>& runs = storedChunk->second.runs;
+    int tileIndex = 0;
+    for (size_t i = 0; i + 1 < runs.size(); i += 2)
+    {
+        for (int j = 0; j < runs[i]; ++j)
+        {
+            tiles[tileIndex++] = static_cast<TILE>(runs[i + 1]);
+        }
+    }
+
+    m_storedByteCount -= runs.size();
+    m_storedChunks.erase(storedChunk);
+    return true;
+}
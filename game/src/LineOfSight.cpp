@@ -0,0 +1,122 @@
+#include <cmath>
+#include <limits>
+#include "PCH.h"
+#include "LineOfSight.h"
+
+// How close two grid line crossings must be for a line to count as passing through the corner between them.
+static float const LINE_OF_SIGHT_CORNER_TOLERANCE = 0.0001f;
+
+// Default constructor.
+LineOfSight::LineOfSight() :
+m_level(nullptr),
+m_size({ 0, 0 }),
+m_origin({ 0.f, 0.f }),
+m_revision(0)
+{
+}
+
+// Rebuilds the solid tiles of a level if it has changed since the last update.
+void LineOfSight::Update(const Level& level)
+{
+    if ((m_level == &level) && (m_size == level.GetSize()) && (m_origin == level.GetPosition()) && (m_revision == level.GetWalkabilityRevision()))
+    {
+        return;
+    }
+
+    m_level = &level;
+    m_size = level.GetSize();
+    m_origin = level.GetPosition();
+    m_revision = level.GetWalkabilityRevision();
+
+    m_walkableTiles = level.GetWalkableTiles();
+}
+
+// Checks if a square box can move in a straight line between two positions without overlapping a solid tile.
+bool LineOfSight::IsClear(sf::Vector2f start, sf::Vector2f end, float halfSize) const
+{
+    // The box is smaller than a tile, so the tiles it sweeps over are exactly the ones its four corners pass through.
+    float const tileSize = static_cast<float>(TILE_SIZE);
+    for (int i = -1; i <= 1; i += 2)
+    {
+        for (int j = -1; j <= 1; j += 2)
+        {
+            sf::Vector2f offset(i * halfSize - m_origin.x, j * halfSize - m_origin.y);
+            if (!IsRayClear((start + offset) / tileSize, (end + offset) / tileSize))
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+// Walks the tiles that a line passes through until it reaches one that is solid.
+bool LineOfSight::IsRayClear(sf::Vector2f start, sf::Vector2f end) const
+{
+    int column = static_cast<int>(std::floor(start.x));
+    int row = static_cast<int>(std::floor(start.y));
+    if (IsSolid(column, row))
+    {
+        return false;
+    }
+
+    int endColumn = static_cast<int>(std::floor(end.x));
+    int endRow = static_cast<int>(std::floor(end.y));
+    int columnSteps = std::abs(endColumn - column);
+    int rowSteps = std::abs(endRow - row);
+    int columnStep = (endColumn > column) ? 1 : -1;
+    int rowStep = (endRow > row) ? 1 : -1;
+
+    // The fraction of the line between one grid line and the next, and how far along it the next grid line is crossed.
+    float const infinity = std::numeric_limits<float>::infinity();
+    float deltaX = (columnSteps > 0) ? 1.f / std::abs(end.x - start.x) : infinity;
+    float deltaY = (rowSteps > 0) ? 1.f / std::abs(end.y - start.y) : infinity;
+    float nextX = (columnSteps > 0) ? ((columnStep > 0) ? (column + 1 - start.x) : (start.x - column)) * deltaX : infinity;
+    float nextY = (rowSteps > 0) ? ((rowStep > 0) ? (row + 1 - start.y) : (start.y - row)) * deltaY : infinity;
+
+    // Step into whichever neighbor the line reaches first, counting steps so rounding can't carry it past the end tile.
+    while ((columnSteps > 0) || (rowSteps > 0))
+    {
+        if ((columnSteps > 0) && (rowSteps > 0) && (std::abs(nextX - nextY) < LINE_OF_SIGHT_CORNER_TOLERANCE))
+        {
+            // Passing through a corner touches both tiles beside it.
+            if (IsSolid(column + columnStep, row) || IsSolid(column, row + rowStep))
+            {
+                return false;
+            }
+            column += columnStep;
+            row += rowStep;
+            nextX += deltaX;
+            nextY += deltaY;
+            columnSteps--;
+            rowSteps--;
+        }
+        else if ((rowSteps == 0) || ((columnSteps > 0) && (nextX < nextY)))
+        {
+            column += columnStep;
+            nextX += deltaX;
+            columnSteps--;
+        }
+        else
+        {
+            row += rowStep;
+            nextY += deltaY;
+            rowSteps--;
+        }
+
+        if (IsSolid(column, row))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Checks if a tile blocks movement.
+bool LineOfSight::IsSolid(int columnIndex, int rowIndex) const
+{
+    // Tiles outside the level read as clear, so they count as solid.
+    return !m_walkableTiles.Test(columnIndex, rowIndex);
+}
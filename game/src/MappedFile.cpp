@@ -0,0 +1,120 @@
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include "PCH.h"
+#include "MappedFile.h"
+
+// Default constructor.
+MappedFile::MappedFile() :
+m_data(nullptr),
+m_size(0)
+{
+}
+
+// Destructor.
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+// Maps a whole file into memory, read only.
+bool MappedFile::Open(const std::string& fileName)
+{
+    Close();
+
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    LARGE_INTEGER size;
+    if ((!GetFileSizeEx(file, &size)) || (size.QuadPart == 0))
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    // The view keeps the mapping open, so both handles can be closed straight away.
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (mapping == nullptr)
+    {
+        return false;
+    }
+
+    void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (data == nullptr)
+    {
+        return false;
+    }
+
+    m_data = static_cast<const unsigned char*>(data);
+    m_size = static_cast<size_t>(size.QuadPart);
+#else
+    int file = open(fileName.c_str(), O_RDONLY);
+    if (file < 0)
+    {
+        return false;
+    }
+
+    struct stat status;
+    if ((fstat(file, &status) != 0) || (status.st_size == 0))
+    {
+        close(file);
+        return false;
+    }
+
+    // The mapping keeps the file open, so the descriptor can be closed straight away.
+    void* data = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+    close(file);
+    if (data == MAP_FAILED)
+    {
+        return false;
+    }
+
+    m_data = static_cast<const unsigned char*>(data);
+    m_size = static_cast<size_t>(status.st_size);
+#endif
+
+    return true;
+}
+
+// Unmaps the file.
+void MappedFile::Close()
+{
+    if (m_data == nullptr)
+    {
+        return;
+    }
+
+#if defined(_WIN32)
+    UnmapViewOfFile(m_data);
+#else
+    munmap(const_cast<unsigned char*>(m_data), m_size);
+#endif
+
+    m_data = nullptr;
+    m_size = 0;
+}
+
+// Gets the contents of the file.
+const unsigned char* MappedFile::GetData() const
+{
+    return m_data;
+}
+
+// Gets the size of the file.
+size_t MappedFile::GetSize() const
+{
+    return m_size;
+}
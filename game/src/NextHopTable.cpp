@@ -0,0 +1,241 @@
+#include <chrono>
+#include "PCH.h"
+#include "NextHopTable.h"
+
+// The column and row offsets of the eight steps. Step 7 - i goes the opposite way to step i.
+static int const NEXT_HOP_COLUMN_OFFSETS[8] = { -1, -1, -1, 0, 0, 1, 1, 1 };
+static int const NEXT_HOP_ROW_OFFSETS[8] = { -1, 0, 1, -1, 1, -1, 0, 1 };
+
+// The entry for a pair of tiles with no path between them.
+static unsigned char const NEXT_HOP_NONE = 0xFF;
+
+// Default constructor.
+NextHopTable::NextHopTable() :
+m_level(nullptr),
+m_size({ 0, 0 }),
+m_revision(0),
+m_buildTime(0),
+m_buildLevel(nullptr),
+m_buildSize({ 0, 0 }),
+m_buildRevision(0),
+m_buildThreadTime(0),
+m_isBuildFinished(false),
+m_cancelBuild(false)
+{
+}
+
+// Destructor.
+NextHopTable::~NextHopTable()
+{
+    m_cancelBuild = true;
+    if (m_buildThread.joinable())
+    {
+        m_buildThread.join();
+    }
+}
+
+// Builds the table for a level on the calling thread.
+void NextHopTable::Build(const Level& level)
+{
+    // A build that is still running would only be replaced by this one.
+    m_cancelBuild = true;
+    FinishBuild();
+
+    m_level = nullptr;
+    m_size = level.GetSize();
+    if (m_size.x * m_size.y > NEXT_HOP_TABLE_MAX_NODE_COUNT)
+    {
+        m_nextHops.clear();
+        return;
+    }
+
+    std::vector<bool> walkable(m_size.x * m_size.y);
+    for (int i = 0; i < m_size.x; i++)
+    {
+        for (int j = 0; j < m_size.y; j++)
+        {
+            walkable[i * m_size.y + j] = level.IsFloor(i, j);
+        }
+    }
+
+    auto buildStart = std::chrono::steady_clock::now();
+    std::atomic<bool> cancel(false);
+    Fill(m_size, walkable, m_nextHops, cancel);
+    m_buildTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - buildStart).count();
+
+    m_level = &level;
+    m_revision = level.GetWalkabilityRevision();
+}
+
+// Starts building the table for a level on a background thread.
+void NextHopTable::BuildInBackground(const Level& level)
+{
+    m_cancelBuild = true;
+    FinishBuild();
+
+    m_buildSize = level.GetSize();
+    if (m_buildSize.x * m_buildSize.y > NEXT_HOP_TABLE_MAX_NODE_COUNT)
+    {
+        return;
+    }
+
+    // Copy what the build needs, so the level is free to change while it runs.
+    m_buildWalkable.assign(m_buildSize.x * m_buildSize.y, false);
+    for (int i = 0; i < m_buildSize.x; i++)
+    {
+        for (int j = 0; j < m_buildSize.y; j++)
+        {
+            m_buildWalkable[i * m_buildSize.y + j] = level.IsFloor(i, j);
+        }
+    }
+    m_buildLevel = &level;
+    m_buildRevision = level.GetWalkabilityRevision();
+
+    m_cancelBuild = false;
+    m_isBuildFinished = false;
+    m_buildThread = std::thread([this]
+    {
+        auto buildStart = std::chrono::steady_clock::now();
+        Fill(m_buildSize, m_buildWalkable, m_buildNextHops, m_cancelBuild);
+        m_buildThreadTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - buildStart).count();
+        m_isBuildFinished = true;
+    });
+}
+
+// Checks if the table can be used for a level.
+bool NextHopTable::IsReady(const Level& level)
+{
+    if (m_buildThread.joinable() && m_isBuildFinished)
+    {
+        FinishBuild();
+    }
+
+    return (!m_nextHops.empty()) && (m_level == &level) && (m_size == level.GetSize()) && (m_revision == level.GetWalkabilityRevision());
+}
+
+// Checks if a background build is running.
+bool NextHopTable::IsBuilding() const
+{
+    return m_buildThread.joinable();
+}
+
+// Waits for a background build to finish, and replaces the table with its result unless it was cancelled.
+void NextHopTable::FinishBuild()
+{
+    if (!m_buildThread.joinable())
+    {
+        return;
+    }
+    m_buildThread.join();
+
+    if (!m_cancelBuild)
+    {
+        // Swap so the old table's memory is reused by the next build.
+        m_nextHops.swap(m_buildNextHops);
+        m_level = m_buildLevel;
+        m_size = m_buildSize;
+        m_revision = m_buildRevision;
+        m_buildTime = m_buildThreadTime;
+    }
+    m_isBuildFinished = false;
+}
+
+// Fills a table with the first step of the shortest path between every pair of tiles.
+void NextHopTable::Fill(sf::Vector2i size, const std::vector<bool>& walkable, std::vector<unsigned char>& nextHops, const std::atomic<bool>& cancel)
+{
+    int nodeCount = size.x * size.y;
+    nextHops.assign(static_cast<size_t>(nodeCount) * nodeCount, NEXT_HOP_NONE);
+
+    std::vector<int> queue;
+    queue.reserve(nodeCount);
+
+    // A breadth first search out from each goal reaches every tile through a neighbor one step closer to the goal.
+    for (int goalIndex = 0; goalIndex < nodeCount; ++goalIndex)
+    {
+        if (cancel)
+        {
+            return;
+        }
+        if (!walkable[goalIndex])
+        {
+            continue;
+        }
+
+        unsigned char* goalHops = &nextHops[static_cast<size_t>(goalIndex) * nodeCount];
+        queue.clear();
+        queue.push_back(goalIndex);
+
+        for (size_t next = 0; next < queue.size(); ++next)
+        {
+            int currentIndex = queue[next];
+            int currentColumn = currentIndex / size.y;
+            int currentRow = currentIndex % size.y;
+
+            for (int direction = 0; direction < 8; ++direction)
+            {
+                int column = currentColumn + NEXT_HOP_COLUMN_OFFSETS[direction];
+                int row = currentRow + NEXT_HOP_ROW_OFFSETS[direction];
+                if ((column < 0) || (column >= size.x) || (row < 0) || (row >= size.y))
+                {
+                    continue;
+                }
+
+                int index = column * size.y + row;
+                if ((!walkable[index]) || (goalHops[index] != NEXT_HOP_NONE) || (index == goalIndex))
+                {
+                    continue;
+                }
+
+                // The first step from the new tile is back the way the search came.
+                goalHops[index] = static_cast<unsigned char>(7 - direction);
+                queue.push_back(index);
+            }
+        }
+    }
+}
+
+// Reads the shortest path between two tiles from the table.
+bool NextHopTable::FindPath(const Level& level, const Tile* startNode, const Tile* goalNode, std::vector<sf::Vector2f>& path) const
+{
+    path.clear();
+
+    int nodeCount = m_size.x * m_size.y;
+    int startIndex = startNode->columnIndex * m_size.y + startNode->rowIndex;
+    int goalIndex = goalNode->columnIndex * m_size.y + goalNode->rowIndex;
+    if (startIndex == goalIndex)
+    {
+        return false;
+    }
+
+    const unsigned char* goalHops = &m_nextHops[static_cast<size_t>(goalIndex) * nodeCount];
+    int column = startNode->columnIndex;
+    int row = startNode->rowIndex;
+
+    for (int index = startIndex; index != goalIndex; index = column * m_size.y + row)
+    {
+        unsigned char direction = goalHops[index];
+        if (direction == NEXT_HOP_NONE)
+        {
+            path.clear();
+            return false;
+        }
+
+        column += NEXT_HOP_COLUMN_OFFSETS[direction];
+        row += NEXT_HOP_ROW_OFFSETS[direction];
+        path.push_back(level.GetActualTileLocation(column, row));
+    }
+
+    return true;
+}
+
+// Gets the memory used by the table.
+size_t NextHopTable::GetMemoryUsage() const
+{
+    return m_nextHops.size() * sizeof(unsigned char);
+}
+
+// Gets the time the last finished build took.
+long long NextHopTable::GetBuildTime() const
+{
+    return m_buildTime;
+}
@@ -0,0 +1,180 @@
+#include "PCH.h"
+#include "NodeHeap.h"
+
+// Default constructor.
+NodeHeap::NodeHeap() :
+m_pushCount(0)
+{
+}
+
+// Prepares the heap to hold the given number of nodes.
+void NodeHeap::Resize(int nodeCount)
+{
+    m_entries.clear();
+    m_entries.reserve(nodeCount);
+    m_positions.assign(nodeCount, -1);
+    m_pushCount = 0;
+}
+
+// Removes all nodes from the heap.
+void NodeHeap::Clear()
+{
+    for (const Entry& entry : m_entries)
+    {
+        m_positions[entry.node] = -1;
+    }
+
+    m_entries.clear();
+    m_pushCount = 0;
+}
+
+// Checks if the heap contains any nodes.
+bool NodeHeap::IsEmpty() const
+{
+    return m_entries.empty();
+}
+
+// Checks if the given node is stored in the heap.
+bool NodeHeap::Contains(int node) const
+{
+    return m_positions[node] != -1;
+}
+
+// Adds a node to the heap.
+void NodeHeap::Push(int node, long long key)
+{
+    m_entries.push_back({ key, m_pushCount++, node });
+    m_positions[node] = static_cast<int>(m_entries.size() - 1);
+    SiftUp(m_entries.size() - 1);
+}
+
+// Removes the node with the lowest key from the heap.
+int NodeHeap::Pop()
+{
+    int node = m_entries.front().node;
+
+    // Move the last entry to the top and restore the heap.
+    SwapEntries(0, m_entries.size() - 1);
+    m_entries.pop_back();
+    m_positions[node] = -1;
+
+    if (!m_entries.empty())
+    {
+        SiftDown(0);
+    }
+
+    return node;
+}
+
+// Lowers the key of a node that is already in the heap.
+void NodeHeap::DecreaseKey(int node, long long key)
+{
+    size_t index = static_cast<size_t>(m_positions[node]);
+    m_entries[index].key = key;
+    SiftUp(index);
+}
+
+// Changes the key of a node that is already in the heap.
+void NodeHeap::UpdateKey(int node, long long key)
+{
+    size_t index = static_cast<size_t>(m_positions[node]);
+    m_entries[index].key = key;
+    SiftUp(index);
+    SiftDown(static_cast<size_t>(m_positions[node]));
+}
+
+// Removes a node from the heap.
+void NodeHeap::Remove(int node)
+{
+    size_t index = static_cast<size_t>(m_positions[node]);
+
+    // Move the last entry into the gap, then restore the heap around it.
+    SwapEntries(index, m_entries.size() - 1);
+    m_entries.pop_back();
+    m_positions[node] = -1;
+
+    if (index < m_entries.size())
+    {
+        int movedNode = m_entries[index].node;
+        SiftUp(index);
+        SiftDown(static_cast<size_t>(m_positions[movedNode]));
+    }
+}
+
+// Gets the lowest key in the heap.
+long long NodeHeap::GetTopKey() const
+{
+    return m_entries.front().key;
+}
+
+// Gets the node with the lowest key without removing it.
+int NodeHeap::GetTop() const
+{
+    return m_entries.front().node;
+}
+
+// Checks if the entry at index a should be popped before the entry at index b.
+bool NodeHeap::IsHigherPriority(size_t a, size_t b) const
+{
+    const Entry& first = m_entries[a];
+    const Entry& second = m_entries[b];
+
+    if (first.key != second.key)
+    {
+        return first.key < second.key;
+    }
+
+    return first.order < second.order;
+}
+
+// Swaps two entries and updates their stored positions.
+void NodeHeap::SwapEntries(size_t a, size_t b)
+{
+    std::swap(m_entries[a], m_entries[b]);
+    m_positions[m_entries[a].node] = static_cast<int>(a);
+    m_positions[m_entries[b].node] = static_cast<int>(b);
+}
+
+// Moves the entry at the given index up until the heap property holds.
+void NodeHeap::SiftUp(size_t index)
+{
+    while (index > 0)
+    {
+        size_t parent = (index - 1) / 2;
+        if (!IsHigherPriority(index, parent))
+        {
+            break;
+        }
+
+        SwapEntries(index, parent);
+        index = parent;
+    }
+}
+
+// Moves the entry at the given index down until the heap property holds.
+void NodeHeap::SiftDown(size_t index)
+{
+    size_t count = m_entries.size();
+    while (true)
+    {
+        size_t left = (index * 2) + 1;
+        size_t right = left + 1;
+        size_t smallest = index;
+
+        if ((left < count) && IsHigherPriority(left, smallest))
+        {
+            smallest = left;
+        }
+        if ((right < count) && IsHigherPriority(right, smallest))
+        {
+            smallest = right;
+        }
+        if (smallest == index)
+        {
+            break;
+        }
+
+        SwapEntries(index, smallest);
+        index = smallest;
+    }
+}
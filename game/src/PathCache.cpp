@@ -0,0 +1,118 @@
+#include "PCH.h"
+#include "PathCache.h"
+
+// Constructor.
+PathCache::PathCache(int capacity) :
+m_capacity(capacity),
+m_level(nullptr),
+m_revision(0),
+m_hitCount(0),
+m_missCount(0)
+{
+}
+
+// Looks up the path between two tiles.
+bool PathCache::Find(const Level& level, const Tile* startNode, const Tile* goalNode, std::vector<sf::Vector2f>& path)
+{
+    CheckLevel(level);
+
+    auto it = m_index.find(GetKey(level, startNode, goalNode));
+    if (it == m_index.end())
+    {
+        m_missCount++;
+        return false;
+    }
+
+    // Move the path to the front of the list, as it's now the most recently used.
+    m_entries.splice(m_entries.begin(), m_entries, it->second);
+    path = it->second->path;
+    m_hitCount++;
+    return true;
+}
+
+// Stores the path between two tiles.
+void PathCache::Store(const Level& level, const Tile* startNode, const Tile* goalNode, const std::vector<sf::Vector2f>& path)
+{
+    CheckLevel(level);
+
+    long long key = GetKey(level, startNode, goalNode);
+    auto it = m_index.find(key);
+    if (it != m_index.end())
+    {
+        m_entries.splice(m_entries.begin(), m_entries, it->second);
+        it->second->path = path;
+        return;
+    }
+
+    // Reuse the least recently used entry when the cache is full, so its path memory is recycled.
+    if (static_cast<int>(m_entries.size()) >= m_capacity)
+    {
+        if (m_entries.empty())
+        {
+            return;
+        }
+        m_index.erase(m_entries.back().key);
+        m_entries.splice(m_entries.begin(), m_entries, std::prev(m_entries.end()));
+    }
+    else
+    {
+        m_entries.emplace_front();
+    }
+
+    Entry& entry = m_entries.front();
+    entry.key = key;
+    entry.path = path;
+    m_index[key] = m_entries.begin();
+}
+
+// Removes all paths from the cache.
+void PathCache::Clear()
+{
+    m_entries.clear();
+    m_index.clear();
+}
+
+// Gets the number of lookups that found a stored path.
+int PathCache::GetHitCount() const
+{
+    return m_hitCount;
+}
+
+// Gets the number of lookups that didn't find a stored path.
+int PathCache::GetMissCount() const
+{
+    return m_missCount;
+}
+
+// Sets the hit and miss counters back to 0.
+void PathCache::ResetCounters()
+{
+    m_hitCount = 0;
+    m_missCount = 0;
+}
+
+// Gets the number of paths in the cache.
+int PathCache::GetSize() const
+{
+    return static_cast<int>(m_entries.size());
+}
+
+// Calculates the key of the path between two tiles.
+long long PathCache::GetKey(const Level& level, const Tile* startNode, const Tile* goalNode)
+{
+    long long nodeCount = static_cast<long long>(level.GetSize().x) * level.GetSize().y;
+    long long startIndex = startNode->columnIndex * level.GetSize().y + startNode->rowIndex;
+    long long goalIndex = goalNode->columnIndex * level.GetSize().y + goalNode->rowIndex;
+    return startIndex * nodeCount + goalIndex;
+}
+
+// Empties the cache if the paths were stored for a different level, or the walkable tiles have changed since.
+void PathCache::CheckLevel(const Level& level)
+{
+    if ((&level != m_level) || (level.GetWalkabilityRevision() != m_revision))
+    {
+        Clear();
+        m_level = &level;
+        m_revision = level.GetWalkabilityRevision();
+    }
+}
@@ -0,0 +1,214 @@
+#include "PCH.h"
+#include "PathfindingBatch.h"
+
+// Constructor.
+PathfindingBatch::PathfindingBatch(int threadCount) :
+m_batchNumber(0),
+m_busyWorkerCount(0),
+m_isStopping(false),
+m_nextSearch(0),
+m_level(nullptr),
+m_mode(PATHFINDING_MODE::A_STAR),
+m_hierarchy(nullptr)
+{
+    if (threadCount <= 0)
+    {
+        threadCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+
+    // The contexts must all exist before any worker starts using them.
+    m_contexts.resize(threadCount);
+    for (int i = 1; i < threadCount; ++i)
+    {
+        m_threads.emplace_back(&PathfindingBatch::WorkerLoop, this, i);
+    }
+}
+
+// Destructor.
+PathfindingBatch::~PathfindingBatch()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_isStopping = true;
+    }
+    m_batchReady.notify_all();
+
+    for (auto& thread : m_threads)
+    {
+        thread.join();
+    }
+}
+
+// Removes all requests from the batch.
+void PathfindingBatch::Clear()
+{
+    m_requests.clear();
+}
+
+// Adds a search to the batch.
+int PathfindingBatch::Add(const Tile* startNode, const Tile* goalNode)
+{
+    m_requests.push_back({ startNode, goalNode });
+    return static_cast<int>(m_requests.size()) - 1;
+}
+
+// Runs all requests in the batch across the worker threads and waits for them to finish.
+void PathfindingBatch::Run(const Level& level, PATHFINDING_MODE mode, const PathfindingHierarchy* hierarchy, PathCache* cache)
+{
+    m_level = &level;
+    m_mode = mode;
+    m_hierarchy = hierarchy;
+
+    int requestCount = static_cast<int>(m_requests.size());
+    if (static_cast<int>(m_paths.size()) < requestCount)
+    {
+        m_paths.resize(requestCount);
+    }
+    m_expandedNodeCounts.assign(requestCount, 0);
+    m_sources.assign(requestCount, -1);
+    m_searches.clear();
+    m_firstRequests.clear();
+
+    // Only search for each start and goal pair once, and not at all if the cache has it.
+    sf::Vector2i levelSize = level.GetSize();
+    for (int i = 0; i < requestCount; ++i)
+    {
+        const Tile* startNode = m_requests[i].first;
+        const Tile* goalNode = m_requests[i].second;
+        long long key = static_cast<long long>(startNode->columnIndex * levelSize.y + startNode->rowIndex) * (levelSize.x * levelSize.y) + (goalNode->columnIndex * levelSize.y + goalNode->rowIndex);
+
+        auto it = m_firstRequests.find(key);
+        if (it != m_firstRequests.end())
+        {
+            m_sources[i] = it->second;
+            continue;
+        }
+        m_firstRequests[key] = i;
+
+        if ((cache == nullptr) || (!cache->Find(level, startNode, goalNode, m_paths[i])))
+        {
+            m_searches.push_back(i);
+        }
+    }
+
+    if ((m_threads.empty()) || (m_searches.size() <= 1))
+    {
+        m_nextSearch = 0;
+        RunSearches(0);
+    }
+    else
+    {
+        // Hand the batch to the workers, and help them run it.
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_nextSearch = 0;
+            m_busyWorkerCount = static_cast<int>(m_threads.size());
+            m_batchNumber++;
+        }
+        m_batchReady.notify_all();
+
+        RunSearches(0);
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_batchFinished.wait(lock, [this] { return m_busyWorkerCount == 0; });
+    }
+
+    // Store the new paths in request order so the cache is the same however the searches were shared out.
+    if (cache != nullptr)
+    {
+        for (int request : m_searches)
+        {
+            cache->Store(level, m_requests[request].first, m_requests[request].second, m_paths[request]);
+        }
+    }
+
+    for (int i = 0; i < requestCount; ++i)
+    {
+        if (m_sources[i] != -1)
+        {
+            m_paths[i] = m_paths[m_sources[i]];
+        }
+    }
+}
+
+// The loop run by each worker thread.
+void PathfindingBatch::WorkerLoop(int workerIndex)
+{
+    unsigned int batchNumber = 0;
+
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_batchReady.wait(lock, [this, batchNumber] { return m_isStopping || (m_batchNumber != batchNumber); });
+            if (m_isStopping)
+            {
+                return;
+            }
+            batchNumber = m_batchNumber;
+        }
+
+        RunSearches(workerIndex);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_busyWorkerCount--;
+            if (m_busyWorkerCount == 0)
+            {
+                m_batchFinished.notify_one();
+            }
+        }
+    }
+}
+
+// Takes searches from the batch and runs them until there are none left.
+void PathfindingBatch::RunSearches(int workerIndex)
+{
+    PathfindingContext& context = m_contexts[workerIndex];
+    int searchCount = static_cast<int>(m_searches.size());
+
+    for (int search = m_nextSearch++; search < searchCount; search = m_nextSearch++)
+    {
+        int request = m_searches[search];
+        const Tile* startNode = m_requests[request].first;
+        const Tile* goalNode = m_requests[request].second;
+
+        if (m_mode == PATHFINDING_MODE::JUMP_POINT_SEARCH)
+        {
+            context.FindJumpPointPath(*m_level, startNode, goalNode, m_paths[request]);
+        }
+        else if ((m_mode == PATHFINDING_MODE::HIERARCHICAL) && (m_hierarchy != nullptr))
+        {
+            context.FindHierarchicalPath(*m_level, *m_hierarchy, startNode, goalNode, m_paths[request]);
+        }
+        else
+        {
+            context.FindPath(*m_level, startNode, goalNode, m_paths[request]);
+        }
+        m_expandedNodeCounts[request] = context.GetExpandedNodeCount();
+    }
+}
+
+// Gets the path found for a request.
+const std::vector<sf::Vector2f>& PathfindingBatch::GetPath(int request) const
+{
+    return m_paths[request];
+}
+
+// Gets the number of nodes expanded for a request.
+int PathfindingBatch::GetExpandedNodeCount(int request) const
+{
+    return m_expandedNodeCounts[request];
+}
+
+// Gets the number of requests in the batch.
+int PathfindingBatch::GetRequestCount() const
+{
+    return static_cast<int>(m_requests.size());
+}
+
+// Gets the number of threads that run searches.
+int PathfindingBatch::GetThreadCount() const
+{
+    return static_cast<int>(m_contexts.size());
+}
@@ -0,0 +1,610 @@
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include "PCH.h"
+#include "PathfindingContext.h"
+
+// Default constructor.
+PathfindingContext::PathfindingContext() :
+m_goalNode(nullptr),
+m_generation(0),
+m_expandedNodeCount(0),
+m_scannedNodeCount(0)
+{
+}
+
+// Gets the number of nodes that the last search expanded.
+int PathfindingContext::GetExpandedNodeCount() const
+{
+    return m_expandedNodeCount;
+}
+
+// Gets the number of tiles that the last jump point search stepped over while jumping.
+int PathfindingContext::GetScannedNodeCount() const
+{
+    return m_scannedNodeCount;
+}
+
+// Prepares the scratch arrays for a new search.
+void PathfindingContext::BeginSearch(int nodeCount)
+{
+    m_expandedNodeCount = 0;
+    m_scannedNodeCount = 0;
+
+    // Only clear the arrays when the level size changes, or when the generation counter wraps around.
+    if ((static_cast<int>(m_generations.size()) != nodeCount) || (m_generation == UINT_MAX))
+    {
+        m_generations.assign(nodeCount, 0);
+        m_parents.resize(nodeCount);
+        m_G.resize(nodeCount);
+        m_F.resize(nodeCount);
+        m_closed.resize(nodeCount);
+        m_openList.Resize(nodeCount);
+        m_generation = 0;
+    }
+
+    // Advancing the generation invalidates the data of every node in one step.
+    m_generation++;
+}
+
+// Checks if the given node has been reached by the current search.
+bool PathfindingContext::IsVisited(int node) const
+{
+    return m_generations[node] == m_generation;
+}
+
+// Marks a node as reached by the current search and initializes its data.
+void PathfindingContext::Visit(int node, int parent, int G, int F)
+{
+    m_generations[node] = m_generation;
+    m_parents[node] = parent;
+    m_G[node] = G;
+    m_F[node] = F;
+    m_closed[node] = false;
+}
+
+// Finds a path between two tiles with A*.
+bool PathfindingContext::FindPath(const Level& level, const Tile* startNode, const Tile* goalNode, std::vector<sf::Vector2f>& path)
+{
+    sf::Vector2i levelSize = level.GetSize();
+    return FindPath(level, startNode, goalNode, sf::IntRect(0, 0, levelSize.x, levelSize.y), path);
+}
+
+// Finds a path between two tiles with A*, without leaving the given area.
+bool PathfindingContext::FindPath(const Level& level, const Tile* startNode, const Tile* goalNode, const sf::IntRect& bounds, std::vector<sf::Vector2f>& path)
+{
+    BeginPath(level, startNode, goalNode, bounds);
+    return ContinuePath(level, INT_MAX, path) == PATHFINDING_STATUS::FOUND;
+}
+
+// Starts an A* search that can be run a few nodes at a time.
+void PathfindingContext::BeginPath(const Level& level, const Tile* startNode, const Tile* goalNode, const sf::IntRect& bounds)
+{
+    sf::Vector2i levelSize = level.GetSize();
+    BeginSearch(levelSize.x * levelSize.y);
+    m_goalNode = goalNode;
+    m_bounds = bounds;
+
+    // Check we have a valid path to find. If not we leave the open list
+    // empty, so the search ends straight away as there's no path to find.
+    if (startNode == goalNode)
+    {
+        return;
+    }
+
+    // Add the start node to the open list. Its heuristic does not affect the search so it is left at 0.
+    int startIndex = startNode->columnIndex * levelSize.y + startNode->rowIndex;
+    Visit(startIndex, -1, 0, 0);
+    m_openList.Push(startIndex, 0);
+}
+
+// Continues the A* search started by BeginPath().
+PATHFINDING_STATUS PathfindingContext::ContinuePath(const Level& level, int maxExpandedNodeCount, std::vector<sf::Vector2f>& path)
+{
+    path.clear();
+
+    sf::Vector2i levelSize = level.GetSize();
+    const Tile* goalNode = m_goalNode;
+    const sf::IntRect& bounds = m_bounds;
+    const TileBitboard& walkableTiles = level.GetWalkableTiles();
+    int goalIndex = goalNode->columnIndex * levelSize.y + goalNode->rowIndex;
+
+    for (int expandedNodeCount = 0; !m_openList.IsEmpty(); expandedNodeCount++)
+    {
+        // Pause once this step has used up its share of the search.
+        if (expandedNodeCount == maxExpandedNodeCount)
+        {
+            return PATHFINDING_STATUS::IN_PROGRESS;
+        }
+
+        // Take the node in the open list with the lowest F value and mark it as current.
+        int currentIndex = m_openList.Pop();
+        int currentColumn = currentIndex / levelSize.y;
+        int currentRow = currentIndex % levelSize.y;
+
+        // Add the current node to the closed list.
+        m_closed[currentIndex] = true;
+        m_expandedNodeCount++;
+
+        // For all adjacent floor tiles. The neighbour mask holds them in column then row order, so they are visited in that order.
+        for (int neighbors = walkableTiles.GetNeighborMask(currentColumn, currentRow); neighbors != 0; neighbors &= neighbors - 1)
+        {
+            int neighbor = FindLowestBit(neighbors);
+            int adjacentColumn = currentColumn + (neighbor / 3) - 1;
+            int adjacentRow = currentRow + (neighbor % 3) - 1;
+            if (!IsInside(bounds, adjacentColumn, adjacentRow))
+            {
+                continue;
+            }
+
+            int adjacentIndex = adjacentColumn * levelSize.y + adjacentRow;
+            if (adjacentIndex == goalIndex)
+            {
+                // Store the path from the goal back to the start, excluding the start node.
+                path.push_back(level.GetActualTileLocation(adjacentColumn, adjacentRow));
+                for (int node = currentIndex; m_parents[node] != -1; node = m_parents[node])
+                {
+                    path.push_back(level.GetActualTileLocation(node / levelSize.y, node % levelSize.y));
+                }
+
+                // Reverse the path as we read it from goal to origin and we need it the other way around.
+                std::reverse(path.begin(), path.end());
+
+                m_openList.Clear();
+                return PATHFINDING_STATUS::FOUND;
+            }
+
+            int G = m_G[currentIndex] + PATHFINDING_STEP_COST;
+            if (!IsVisited(adjacentIndex))
+            {
+                // Calculate the Manhattan distance to the goal, and add the node to the open list.
+                int H = std::abs(adjacentRow - goalNode->rowIndex) + std::abs(adjacentColumn - goalNode->columnIndex);
+                Visit(adjacentIndex, currentIndex, G, G + H);
+                m_openList.Push(adjacentIndex, G + H);
+            }
+            else if ((!m_closed[adjacentIndex]) && (G < m_G[adjacentIndex]))
+            {
+                // It's faster to reach the node through the current one. Re-parent it and move it up the open list.
+                m_F[adjacentIndex] -= m_G[adjacentIndex] - G;
+                m_G[adjacentIndex] = G;
+                m_parents[adjacentIndex] = currentIndex;
+                m_openList.DecreaseKey(adjacentIndex, m_F[adjacentIndex]);
+            }
+        }
+    }
+
+    // The open list ran out before reaching the goal, so there is no path.
+    return PATHFINDING_STATUS::NOT_FOUND;
+}
+
+// Checks if a tile can be walked on.
+bool PathfindingContext::IsWalkable(const Level& level, int columnIndex, int rowIndex) const
+{
+    return level.TileIsValid(columnIndex, rowIndex) && level.IsFloor(columnIndex, rowIndex);
+}
+
+// Calculates the cost of reaching every tile in an area from a tile.
+void PathfindingContext::FindCosts(const Level& level, const Tile* startNode, const sf::IntRect& bounds)
+{
+    sf::Vector2i levelSize = level.GetSize();
+    BeginSearch(levelSize.x * levelSize.y);
+
+    // Every step has the same cost, so a breadth first search reaches tiles in order of their cost.
+    int startIndex = startNode->columnIndex * levelSize.y + startNode->rowIndex;
+    Visit(startIndex, -1, 0, 0);
+    m_queue.clear();
+    m_queue.push_back(startIndex);
+
+    for (size_t next = 0; next < m_queue.size(); ++next)
+    {
+        int currentIndex = m_queue[next];
+        int currentColumn = currentIndex / levelSize.y;
+        int currentRow = currentIndex % levelSize.y;
+        m_expandedNodeCount++;
+
+        for (int i = -1; i <= 1; i++)
+        {
+            for (int j = -1; j <= 1; j++)
+            {
+                int column = currentColumn + i;
+                int row = currentRow + j;
+                if ((!IsInside(bounds, column, row)) || (!IsWalkable(level, column, row)))
+                {
+                    continue;
+                }
+
+                int index = column * levelSize.y + row;
+                if (!IsVisited(index))
+                {
+                    int G = m_G[currentIndex] + PATHFINDING_STEP_COST;
+                    Visit(index, currentIndex, G, G);
+                    m_queue.push_back(index);
+                }
+            }
+        }
+    }
+}
+
+// Reaches a node of the abstract graph through an edge.
+void PathfindingContext::RelaxEdge(int node, const PathfindingEdge& edge, const Tile* goalNode, int levelHeight)
+{
+    if (IsVisited(edge.node) && m_closed[edge.node])
+    {
+        return;
+    }
+
+    int G = m_G[node] + edge.cost;
+    if (!IsVisited(edge.node))
+    {
+        // Every step costs the same, so the diagonal distance never overestimates.
+        int dx = std::abs(edge.node / levelHeight - goalNode->columnIndex);
+        int dy = std::abs(edge.node % levelHeight - goalNode->rowIndex);
+        int F = G + PATHFINDING_STEP_COST * std::max(dx, dy);
+        Visit(edge.node, node, G, F);
+        m_openList.Push(edge.node, F);
+    }
+    else if (G < m_G[edge.node])
+    {
+        m_F[edge.node] -= m_G[edge.node] - G;
+        m_G[edge.node] = G;
+        m_parents[edge.node] = node;
+        m_openList.DecreaseKey(edge.node, m_F[edge.node]);
+    }
+}
+
+// Checks if a tile lies inside an area.
+bool PathfindingContext::IsInside(const sf::IntRect& bounds, int columnIndex, int rowIndex)
+{
+    return (columnIndex >= bounds.left) && (columnIndex < bounds.left + bounds.width) && (rowIndex >= bounds.top) && (rowIndex < bounds.top + bounds.height);
+}
+
+// Calculates the octile distance between two tiles.
+int PathfindingContext::OctileDistance(int columnA, int rowA, int columnB, int rowB)
+{
+    int dx = std::abs(columnA - columnB);
+    int dy = std::abs(rowA - rowB);
+    return (PATHFINDING_STEP_COST * std::abs(dx - dy)) + (PATHFINDING_DIAGONAL_STEP_COST * std::min(dx, dy));
+}
+
+// Moves from a tile in the given direction until a jump point is found.
+int PathfindingContext::Jump(const Level& level, int columnIndex, int rowIndex, int dx, int dy, const Tile* goalNode)
+{
+    sf::Vector2i levelSize = level.GetSize();
+
+    while (true)
+    {
+        columnIndex += dx;
+        rowIndex += dy;
+
+        if (!IsWalkable(level, columnIndex, rowIndex))
+        {
+            return -1;
+        }
+
+        m_scannedNodeCount++;
+        int index = columnIndex * levelSize.y + rowIndex;
+
+        if ((columnIndex == goalNode->columnIndex) && (rowIndex == goalNode->rowIndex))
+        {
+            return index;
+        }
+
+        if ((dx != 0) && (dy != 0))
+        {
+            // Diagonal move. A wall behind us on either side opens a neighbour that can't be reached more cheaply another way.
+            if ((!IsWalkable(level, columnIndex - dx, rowIndex) && IsWalkable(level, columnIndex - dx, rowIndex + dy)) ||
+                (!IsWalkable(level, columnIndex, rowIndex - dy) && IsWalkable(level, columnIndex + dx, rowIndex - dy)))
+            {
+                return index;
+            }
+
+            // Any jump point along the straight components makes this tile a jump point.
+            if ((Jump(level, columnIndex, rowIndex, dx, 0, goalNode) != -1) || (Jump(level, columnIndex, rowIndex, 0, dy, goalNode) != -1))
+            {
+                return index;
+            }
+        }
+        else if (dx != 0)
+        {
+            // Horizontal move.
+            if ((!IsWalkable(level, columnIndex, rowIndex + 1) && IsWalkable(level, columnIndex + dx, rowIndex + 1)) ||
+                (!IsWalkable(level, columnIndex, rowIndex - 1) && IsWalkable(level, columnIndex + dx, rowIndex - 1)))
+            {
+                return index;
+            }
+        }
+        else
+        {
+            // Vertical move.
+            if ((!IsWalkable(level, columnIndex + 1, rowIndex) && IsWalkable(level, columnIndex + 1, rowIndex + dy)) ||
+                (!IsWalkable(level, columnIndex - 1, rowIndex) && IsWalkable(level, columnIndex - 1, rowIndex + dy)))
+            {
+                return index;
+            }
+        }
+    }
+}
+
+// Finds a path between two tiles with jump point search.
+bool PathfindingContext::FindJumpPointPath(const Level& level, const Tile* startNode, const Tile* goalNode, std::vector<sf::Vector2f>& path)
+{
+    path.clear();
+
+    sf::Vector2i levelSize = level.GetSize();
+    BeginSearch(levelSize.x * levelSize.y);
+
+    if ((startNode == goalNode) || (!level.IsFloor(*goalNode)))
+    {
+        return false;
+    }
+
+    int startIndex = startNode->columnIndex * levelSize.y + startNode->rowIndex;
+    int goalIndex = goalNode->columnIndex * levelSize.y + goalNode->rowIndex;
+    Visit(startIndex, -1, 0, 0);
+    m_openList.Push(startIndex, 0);
+
+    while (!m_openList.IsEmpty())
+    {
+        int currentIndex = m_openList.Pop();
+        int currentColumn = currentIndex / levelSize.y;
+        int currentRow = currentIndex % levelSize.y;
+
+        m_closed[currentIndex] = true;
+        m_expandedNodeCount++;
+
+        if (currentIndex == goalIndex)
+        {
+            // Walk back through the jump points, filling in every tile between them.
+            for (int node = goalIndex; m_parents[node] != -1; node = m_parents[node])
+            {
+                int parent = m_parents[node];
+                int column = node / levelSize.y;
+                int row = node % levelSize.y;
+                int dx = (parent / levelSize.y > column) - (parent / levelSize.y < column);
+                int dy = (parent % levelSize.y > row) - (parent % levelSize.y < row);
+
+                while ((column * levelSize.y + row) != parent)
+                {
+                    path.push_back(level.GetActualTileLocation(column, row));
+                    column += dx;
+                    row += dy;
+                }
+            }
+
+            std::reverse(path.begin(), path.end());
+            m_openList.Clear();
+            return true;
+        }
+
+        // Work out which directions to search in. The start node searches in all of them, other nodes only
+        // continue in the direction they were reached from, plus any directions opened up by walls.
+        sf::Vector2i directions[8];
+        int directionCount = 0;
+        int parent = m_parents[currentIndex];
+
+        if (parent == -1)
+        {
+            for (int i = -1; i <= 1; i++)
+            {
+                for (int j = -1; j <= 1; j++)
+                {
+                    if ((i != 0) || (j != 0))
+                    {
+                        directions[directionCount++] = { i, j };
+                    }
+                }
+            }
+        }
+        else
+        {
+            int dx = (currentColumn > parent / levelSize.y) - (currentColumn < parent / levelSize.y);
+            int dy = (currentRow > parent % levelSize.y) - (currentRow < parent % levelSize.y);
+
+            if ((dx != 0) && (dy != 0))
+            {
+                directions[directionCount++] = { dx, dy };
+                directions[directionCount++] = { dx, 0 };
+                directions[directionCount++] = { 0, dy };
+                if (!IsWalkable(level, currentColumn - dx, currentRow))
+                {
+                    directions[directionCount++] = { -dx, dy };
+                }
+                if (!IsWalkable(level, currentColumn, currentRow - dy))
+                {
+                    directions[directionCount++] = { dx, -dy };
+                }
+            }
+            else if (dx != 0)
+            {
+                directions[directionCount++] = { dx, 0 };
+                if (!IsWalkable(level, currentColumn, currentRow + 1))
+                {
+                    directions[directionCount++] = { dx, 1 };
+                }
+                if (!IsWalkable(level, currentColumn, currentRow - 1))
+                {
+                    directions[directionCount++] = { dx, -1 };
+                }
+            }
+            else
+            {
+                directions[directionCount++] = { 0, dy };
+                if (!IsWalkable(level, currentColumn + 1, currentRow))
+                {
+                    directions[directionCount++] = { 1, dy };
+                }
+                if (!IsWalkable(level, currentColumn - 1, currentRow))
+                {
+                    directions[directionCount++] = { -1, dy };
+                }
+            }
+        }
+
+        // Jump in each direction and add the jump points found to the open list.
+        for (int i = 0; i < directionCount; i++)
+        {
+            int jumpIndex = Jump(level, currentColumn, currentRow, directions[i].x, directions[i].y, goalNode);
+            if ((jumpIndex == -1) || (IsVisited(jumpIndex) && m_closed[jumpIndex]))
+            {
+                continue;
+            }
+
+            int jumpColumn = jumpIndex / levelSize.y;
+            int jumpRow = jumpIndex % levelSize.y;
+            int G = m_G[currentIndex] + OctileDistance(currentColumn, currentRow, jumpColumn, jumpRow);
+
+            if (!IsVisited(jumpIndex))
+            {
+                int F = G + OctileDistance(jumpColumn, jumpRow, goalNode->columnIndex, goalNode->rowIndex);
+                Visit(jumpIndex, currentIndex, G, F);
+                m_openList.Push(jumpIndex, F);
+            }
+            else if (G < m_G[jumpIndex])
+            {
+                m_F[jumpIndex] -= m_G[jumpIndex] - G;
+                m_G[jumpIndex] = G;
+                m_parents[jumpIndex] = currentIndex;
+                m_openList.DecreaseKey(jumpIndex, m_F[jumpIndex]);
+            }
+        }
+    }
+
+    // The open list ran out before reaching the goal, so there is no path.
+    return false;
+}
+
+// Finds a path between two tiles through the abstract graph of a pathfinding hierarchy.
+bool PathfindingContext::FindHierarchicalPath(const Level& level, const PathfindingHierarchy& hierarchy, const Tile* startNode, const Tile* goalNode, std::vector<sf::Vector2f>& path)
+{
+    path.clear();
+
+    if ((startNode == goalNode) || (!level.IsFloor(*goalNode)))
+    {
+        m_expandedNodeCount = 0;
+        return false;
+    }
+
+    sf::Vector2i levelSize = level.GetSize();
+    int startIndex = startNode->columnIndex * levelSize.y + startNode->rowIndex;
+    int goalIndex = goalNode->columnIndex * levelSize.y + goalNode->rowIndex;
+    int startCluster = hierarchy.GetClusterIndex(startNode->columnIndex, startNode->rowIndex);
+    int goalCluster = hierarchy.GetClusterIndex(goalNode->columnIndex, goalNode->rowIndex);
+
+    // Short paths that stay inside one cluster don't need the abstract graph.
+    int expandedNodeCount = 0;
+    if (startCluster == goalCluster)
+    {
+        if (FindPath(level, startNode, goalNode, hierarchy.GetClusterBounds(startCluster), path))
+        {
+            return true;
+        }
+        expandedNodeCount += m_expandedNodeCount;
+    }
+
+    // Link the start and goal to the entrances of their clusters.
+    m_startEdges.clear();
+    FindCosts(level, startNode, hierarchy.GetClusterBounds(startCluster));
+    expandedNodeCount += m_expandedNodeCount;
+    for (int node : hierarchy.GetEntrances(startCluster))
+    {
+        if (IsVisited(node))
+        {
+            m_startEdges.push_back({ node, m_G[node] });
+        }
+    }
+
+    m_goalEdges.clear();
+    FindCosts(level, goalNode, hierarchy.GetClusterBounds(goalCluster));
+    expandedNodeCount += m_expandedNodeCount;
+    for (int node : hierarchy.GetEntrances(goalCluster))
+    {
+        if (IsVisited(node))
+        {
+            m_goalEdges.push_back({ node, m_G[node] });
+        }
+    }
+
+    // A* over the entrances.
+    BeginSearch(levelSize.x * levelSize.y);
+    Visit(startIndex, -1, 0, 0);
+    m_openList.Push(startIndex, 0);
+    m_abstractPath.clear();
+
+    while (!m_openList.IsEmpty())
+    {
+        int currentIndex = m_openList.Pop();
+        m_closed[currentIndex] = true;
+        expandedNodeCount++;
+
+        if (currentIndex == goalIndex)
+        {
+            for (int node = goalIndex; node != -1; node = m_parents[node])
+            {
+                m_abstractPath.push_back(node);
+            }
+            std::reverse(m_abstractPath.begin(), m_abstractPath.end());
+            m_openList.Clear();
+            break;
+        }
+
+        // The start is linked to its cluster's entrances, and the entrances of the goal cluster are linked to the goal.
+        for (const auto& edge : hierarchy.GetEdges(currentIndex))
+        {
+            RelaxEdge(currentIndex, edge, goalNode, levelSize.y);
+        }
+
+        if (currentIndex == startIndex)
+        {
+            for (const auto& edge : m_startEdges)
+            {
+                RelaxEdge(currentIndex, edge, goalNode, levelSize.y);
+            }
+        }
+
+        for (const auto& edge : m_goalEdges)
+        {
+            if (edge.node == currentIndex)
+            {
+                RelaxEdge(currentIndex, { goalIndex, edge.cost }, goalNode, levelSize.y);
+            }
+        }
+    }
+
+    if (m_abstractPath.empty())
+    {
+        m_expandedNodeCount = expandedNodeCount;
+        return false;
+    }
+
+    // Refine each abstract step into tiles. Steps between neighbouring tiles cross a cluster border,
+    // every other step stays inside one cluster.
+    for (size_t i = 1; i < m_abstractPath.size(); i++)
+    {
+        int from = m_abstractPath[i - 1];
+        int to = m_abstractPath[i];
+        int fromColumn = from / levelSize.y;
+        int fromRow = from % levelSize.y;
+        int toColumn = to / levelSize.y;
+        int toRow = to % levelSize.y;
+
+        if ((std::abs(fromColumn - toColumn) <= 1) && (std::abs(fromRow - toRow) <= 1))
+        {
+            path.push_back(level.GetActualTileLocation(toColumn, toRow));
+            continue;
+        }
+
+        bool found = FindPath(level, level.GetTile(fromColumn, fromRow), level.GetTile(toColumn, toRow), hierarchy.GetClusterBounds(hierarchy.GetClusterIndex(fromColumn, fromRow)), m_segment);
+        expandedNodeCount += m_expandedNodeCount;
+        if (!found)
+        {
+            // The hierarchy is out of date with the level.
+            path.clear();
+            m_expandedNodeCount = expandedNodeCount;
+            return false;
+        }
+        path.insert(path.end(), m_segment.begin(), m_segment.end());
+    }
+
+    m_expandedNodeCount = expandedNodeCount;
+    return true;
+}
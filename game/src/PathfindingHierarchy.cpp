@@ -0,0 +1,309 @@
+#include <algorithm>
+#include "PCH.h"
+#include "PathfindingHierarchy.h"
+#include "PathfindingContext.h"
+
+// Default constructor.
+PathfindingHierarchy::PathfindingHierarchy() :
+m_size({ 0, 0 }),
+m_clusterCount({ 0, 0 }),
+m_revision(0)
+{
+}
+
+// Brings the abstract graph up to date with the level.
+int PathfindingHierarchy::Update(const Level& level)
+{
+    // A new level, or too many changes to replay, needs a full rebuild.
+    if ((level.GetSize() != m_size) || (!level.GetChangedTiles(m_revision, m_changedTiles)))
+    {
+        Build(level);
+        return static_cast<int>(m_entrances.size());
+    }
+    m_revision = level.GetLayoutRevision();
+
+    // A tile can only affect paths through its own cluster, and crossings into the clusters next to it.
+    m_dirtyClusters.clear();
+    for (const auto& tile : m_changedTiles)
+    {
+        int index = tile.x * m_size.y + tile.y;
+        bool walkable = level.IsFloor(tile.x, tile.y);
+        if (m_walkable[index] == walkable)
+        {
+            continue;
+        }
+        m_walkable[index] = walkable;
+
+        for (int i = -1; i <= 1; i++)
+        {
+            for (int j = -1; j <= 1; j++)
+            {
+                if (level.TileIsValid(tile.x + i, tile.y + j))
+                {
+                    int clusterIndex = GetClusterIndex(tile.x + i, tile.y + j);
+                    if (std::find(m_dirtyClusters.begin(), m_dirtyClusters.end(), clusterIndex) == m_dirtyClusters.end())
+                    {
+                        m_dirtyClusters.push_back(clusterIndex);
+                    }
+                }
+            }
+        }
+    }
+
+    for (int clusterIndex : m_dirtyClusters)
+    {
+        BuildCluster(clusterIndex);
+    }
+
+    return static_cast<int>(m_dirtyClusters.size());
+}
+
+// Rebuilds the whole graph for the level.
+void PathfindingHierarchy::Build(const Level& level)
+{
+    m_size = level.GetSize();
+    m_revision = level.GetLayoutRevision();
+    m_clusterCount.x = (m_size.x + PATHFINDING_CLUSTER_SIZE - 1) / PATHFINDING_CLUSTER_SIZE;
+    m_clusterCount.y = (m_size.y + PATHFINDING_CLUSTER_SIZE - 1) / PATHFINDING_CLUSTER_SIZE;
+
+    int nodeCount = m_size.x * m_size.y;
+    m_walkable.assign(nodeCount, false);
+    for (int i = 0; i < m_size.x; i++)
+    {
+        for (int j = 0; j < m_size.y; j++)
+        {
+            m_walkable[i * m_size.y + j] = level.IsFloor(i, j);
+        }
+    }
+
+    m_entrances.assign(m_clusterCount.x * m_clusterCount.y, std::vector<int>());
+    m_edges.assign(nodeCount, std::vector<PathfindingEdge>());
+    m_distances.assign(nodeCount, -1);
+
+    for (int clusterIndex = 0; clusterIndex < static_cast<int>(m_entrances.size()); clusterIndex++)
+    {
+        BuildCluster(clusterIndex);
+    }
+}
+
+// Rebuilds the entrances and edges of one cluster.
+void PathfindingHierarchy::BuildCluster(int clusterIndex)
+{
+    std::vector<int>& entrances = m_entrances[clusterIndex];
+    for (int node : entrances)
+    {
+        m_edges[node].clear();
+    }
+    entrances.clear();
+
+    // Connect the cluster to each of its neighbours. The neighbours add the edges in the other direction.
+    int clusterColumn = clusterIndex / m_clusterCount.y;
+    int clusterRow = clusterIndex % m_clusterCount.y;
+
+    for (int i = -1; i <= 1; i++)
+    {
+        for (int j = -1; j <= 1; j++)
+        {
+            int neighbourColumn = clusterColumn + i;
+            int neighbourRow = clusterRow + j;
+            if (((i == 0) && (j == 0)) || (neighbourColumn < 0) || (neighbourColumn >= m_clusterCount.x) || (neighbourRow < 0) || (neighbourRow >= m_clusterCount.y))
+            {
+                continue;
+            }
+
+            FindCrossings(clusterIndex, neighbourColumn * m_clusterCount.y + neighbourRow, m_crossings);
+            for (const auto& crossing : m_crossings)
+            {
+                if (std::find(entrances.begin(), entrances.end(), crossing.first) == entrances.end())
+                {
+                    entrances.push_back(crossing.first);
+                }
+                m_edges[crossing.first].push_back({ crossing.second, PATHFINDING_STEP_COST });
+            }
+        }
+    }
+
+    // Connect the entrances to each other with the cost of the shortest path between them inside the cluster.
+    sf::IntRect bounds = GetClusterBounds(clusterIndex);
+    for (int node : entrances)
+    {
+        for (int i = bounds.left; i < bounds.left + bounds.width; i++)
+        {
+            for (int j = bounds.top; j < bounds.top + bounds.height; j++)
+            {
+                m_distances[i * m_size.y + j] = -1;
+            }
+        }
+
+        // Breadth first search outwards from the entrance, without leaving the cluster.
+        m_distances[node] = 0;
+        m_openList.clear();
+        m_openList.push_back(node);
+
+        for (size_t next = 0; next < m_openList.size(); ++next)
+        {
+            int currentIndex = m_openList[next];
+            int currentColumn = currentIndex / m_size.y;
+            int currentRow = currentIndex % m_size.y;
+
+            for (int i = -1; i <= 1; i++)
+            {
+                for (int j = -1; j <= 1; j++)
+                {
+                    int column = currentColumn + i;
+                    int row = currentRow + j;
+                    if ((column < bounds.left) || (column >= bounds.left + bounds.width) || (row < bounds.top) || (row >= bounds.top + bounds.height) || (!IsWalkable(column, row)))
+                    {
+                        continue;
+                    }
+
+                    int index = column * m_size.y + row;
+                    if (m_distances[index] == -1)
+                    {
+                        m_distances[index] = m_distances[currentIndex] + 1;
+                        m_openList.push_back(index);
+                    }
+                }
+            }
+        }
+
+        for (int otherNode : entrances)
+        {
+            if ((otherNode != node) && (m_distances[otherNode] > 0))
+            {
+                m_edges[node].push_back({ otherNode, m_distances[otherNode] * PATHFINDING_STEP_COST });
+            }
+        }
+    }
+}
+
+// Finds the places where a path can cross from one cluster into a neighbouring one.
+void PathfindingHierarchy::FindCrossings(int clusterIndex, int neighbourIndex, std::vector<std::pair<int, int>>& crossings) const
+{
+    crossings.clear();
+
+    // Always scan a border from the same side, so that both clusters agree on where the crossings are.
+    int firstIndex = clusterIndex;
+    int secondIndex = neighbourIndex;
+    sf::Vector2i direction(neighbourIndex / m_clusterCount.y - clusterIndex / m_clusterCount.y, neighbourIndex % m_clusterCount.y - clusterIndex % m_clusterCount.y);
+    bool swapped = (direction.x < 0) || ((direction.x == 0) && (direction.y < 0));
+    if (swapped)
+    {
+        std::swap(firstIndex, secondIndex);
+        direction = -direction;
+    }
+
+    sf::IntRect bounds = GetClusterBounds(firstIndex);
+
+    if ((direction.x != 0) && (direction.y != 0))
+    {
+        // Diagonal neighbours only touch at a corner. The corner is only needed if the path can't go around it.
+        sf::Vector2i corner(bounds.left + bounds.width - 1, (direction.y > 0) ? (bounds.top + bounds.height - 1) : bounds.top);
+        if (IsWalkable(corner.x, corner.y) && IsWalkable(corner.x + direction.x, corner.y + direction.y) &&
+            (!IsWalkable(corner.x + direction.x, corner.y)) && (!IsWalkable(corner.x, corner.y + direction.y)))
+        {
+            crossings.push_back({ corner.x * m_size.y + corner.y, (corner.x + direction.x) * m_size.y + corner.y + direction.y });
+        }
+    }
+    else
+    {
+        // Walk along the last column or row of the first cluster.
+        sf::Vector2i start = (direction.x != 0) ? sf::Vector2i(bounds.left + bounds.width - 1, bounds.top) : sf::Vector2i(bounds.left, bounds.top + bounds.height - 1);
+        sf::Vector2i along = (direction.x != 0) ? sf::Vector2i(0, 1) : sf::Vector2i(1, 0);
+        int length = (direction.x != 0) ? bounds.height : bounds.width;
+
+        // Each run of tiles that are open on both sides of the border gets one crossing, in the middle of the run.
+        int runStart = -1;
+        for (int k = 0; k <= length; k++)
+        {
+            sf::Vector2i tile = start + along * k;
+            bool open = (k < length) && IsWalkable(tile.x, tile.y) && IsWalkable(tile.x + direction.x, tile.y + direction.y);
+            if (open && (runStart == -1))
+            {
+                runStart = k;
+            }
+            else if ((!open) && (runStart != -1))
+            {
+                tile = start + along * ((runStart + k - 1) / 2);
+                crossings.push_back({ tile.x * m_size.y + tile.y, (tile.x + direction.x) * m_size.y + tile.y + direction.y });
+                runStart = -1;
+            }
+        }
+
+        // Diagonal steps across the border that aren't next to a straight crossing need one of their own.
+        for (int k = 0; k < length - 1; k++)
+        {
+            sf::Vector2i first = start + along * k;
+            sf::Vector2i second = first + along;
+            bool firstOpen = IsWalkable(first.x, first.y);
+            bool secondOpen = IsWalkable(second.x, second.y);
+            bool firstAcrossOpen = IsWalkable(first.x + direction.x, first.y + direction.y);
+            bool secondAcrossOpen = IsWalkable(second.x + direction.x, second.y + direction.y);
+
+            if (firstOpen && secondAcrossOpen && (!secondOpen) && (!firstAcrossOpen))
+            {
+                crossings.push_back({ first.x * m_size.y + first.y, (second.x + direction.x) * m_size.y + second.y + direction.y });
+            }
+            else if (secondOpen && firstAcrossOpen && (!firstOpen) && (!secondAcrossOpen))
+            {
+                crossings.push_back({ second.x * m_size.y + second.y, (first.x + direction.x) * m_size.y + first.y + direction.y });
+            }
+        }
+    }
+
+    if (swapped)
+    {
+        for (auto& crossing : crossings)
+        {
+            std::swap(crossing.first, crossing.second);
+        }
+    }
+}
+
+// Checks if a tile could be walked on when the graph was built.
+bool PathfindingHierarchy::IsWalkable(int columnIndex, int rowIndex) const
+{
+    if ((columnIndex < 0) || (columnIndex >= m_size.x) || (rowIndex < 0) || (rowIndex >= m_size.y))
+    {
+        return false;
+    }
+
+    return m_walkable[columnIndex * m_size.y + rowIndex];
+}
+
+// Gets the cluster that a tile belongs to.
+int PathfindingHierarchy::GetClusterIndex(int columnIndex, int rowIndex) const
+{
+    return (columnIndex / PATHFINDING_CLUSTER_SIZE) * m_clusterCount.y + (rowIndex / PATHFINDING_CLUSTER_SIZE);
+}
+
+// Gets the tiles covered by a cluster.
+sf::IntRect PathfindingHierarchy::GetClusterBounds(int clusterIndex) const
+{
+    int left = (clusterIndex / m_clusterCount.y) * PATHFINDING_CLUSTER_SIZE;
+    int top = (clusterIndex % m_clusterCount.y) * PATHFINDING_CLUSTER_SIZE;
+    return sf::IntRect(left, top, std::min(PATHFINDING_CLUSTER_SIZE, m_size.x - left), std::min(PATHFINDING_CLUSTER_SIZE, m_size.y - top));
+}
+
+// Gets the entrance tiles of a cluster.
+const std::vector<int>& PathfindingHierarchy::GetEntrances(int clusterIndex) const
+{
+    return m_entrances[clusterIndex];
+}
+
+// Gets the edges leaving a tile in the abstract graph.
+const std::vector<PathfindingEdge>& PathfindingHierarchy::GetEdges(int node) const
+{
+    return m_edges[node];
+}
+
+// Gets the number of entrance tiles in the abstract graph.
+int PathfindingHierarchy::GetEntranceCount() const
+{
+    int count = 0;
+    for (const auto& entrances : m_entrances)
+    {
+        count += static_cast<int>(entrances.size());
+    }
+    return count;
+}
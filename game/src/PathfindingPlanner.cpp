@@ -0,0 +1,317 @@
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include "PCH.h"
+#include "PathfindingPlanner.h"
+#include "PathfindingContext.h"
+
+// The cost of a node that can't reach the goal.
+static int const PLANNER_INFINITE_COST = INT_MAX / 2;
+
+// The key modifier at which the search starts again, so keys can't overflow.
+static int const PLANNER_MAX_KEY_MODIFIER = INT_MAX / 4;
+
+// Keys hold two numbers, compared in order. The first is multiplied by this so it always outweighs the second.
+static long long const PLANNER_KEY_SCALE = 1LL << 31;
+
+// Default constructor.
+PathfindingPlanner::PathfindingPlanner() :
+m_level(nullptr),
+m_size({ 0, 0 }),
+m_revision(0),
+m_startIndex(-1),
+m_goalIndex(-1),
+m_keyModifier(0),
+m_isRepair(false),
+m_expandedNodeCount(0),
+m_touchedNodeCount(0)
+{
+}
+
+// Finds a path between two tiles with D* Lite.
+bool PathfindingPlanner::FindPath(const Level& level, const Tile* startNode, const Tile* goalNode, std::vector<sf::Vector2f>& path)
+{
+    path.clear();
+    m_expandedNodeCount = 0;
+    m_touchedNodeCount = 0;
+
+    sf::Vector2i levelSize = level.GetSize();
+    int startIndex = startNode->columnIndex * levelSize.y + startNode->rowIndex;
+    int goalIndex = goalNode->columnIndex * levelSize.y + goalNode->rowIndex;
+
+    // The tree can only be repaired on the same level, when the goal has moved no more than one tile.
+    bool canRepair = (m_level == &level) && (m_size == levelSize) && (m_goalIndex != -1) && (m_keyModifier < PLANNER_MAX_KEY_MODIFIER)
+        && (Heuristic(m_goalIndex, goalIndex) <= PATHFINDING_STEP_COST) && level.GetChangedTiles(m_revision, m_changedTiles);
+
+    if (!canRepair)
+    {
+        Initialize(level, startIndex, goalIndex);
+    }
+    else
+    {
+        m_isRepair = true;
+        m_revision = level.GetLayoutRevision();
+
+        // Keys are measured from the start, so moving it lowers them all by at most the distance moved.
+        // Adding that distance to new keys instead keeps the ones already in the open list in order.
+        if (startIndex != m_startIndex)
+        {
+            m_keyModifier += Heuristic(m_startIndex, startIndex);
+            m_startIndex = startIndex;
+        }
+
+        // The old goal becomes an ordinary node, and the new one costs nothing to reach.
+        if (goalIndex != m_goalIndex)
+        {
+            int previousGoalIndex = m_goalIndex;
+            m_goalIndex = goalIndex;
+            m_rhs[goalIndex] = 0;
+            UpdateNode(goalIndex);
+            UpdateNode(previousGoalIndex);
+        }
+
+        // A tile changing between floor and solid changes its own cost and the costs of its neighbors.
+        for (const auto& tile : m_changedTiles)
+        {
+            int index = tile.x * m_size.y + tile.y;
+            bool walkable = level.IsFloor(tile.x, tile.y);
+            if (m_walkable[index] == walkable)
+            {
+                continue;
+            }
+            m_walkable[index] = walkable;
+
+            for (int i = -1; i <= 1; i++)
+            {
+                for (int j = -1; j <= 1; j++)
+                {
+                    if (level.TileIsValid(tile.x + i, tile.y + j))
+                    {
+                        UpdateNode((tile.x + i) * m_size.y + (tile.y + j));
+                    }
+                }
+            }
+        }
+    }
+
+    ComputeShortestPath();
+
+    if ((startIndex == goalIndex) || (m_G[startIndex] >= PLANNER_INFINITE_COST))
+    {
+        return false;
+    }
+
+    // Every node knows its cost to the goal, so the path steps to the cheapest neighbor each time.
+    int currentIndex = startIndex;
+    while (currentIndex != goalIndex)
+    {
+        int currentColumn = currentIndex / m_size.y;
+        int currentRow = currentIndex % m_size.y;
+        int nextIndex = -1;
+
+        for (int i = -1; i <= 1; i++)
+        {
+            for (int j = -1; j <= 1; j++)
+            {
+                int column = currentColumn + i;
+                int row = currentRow + j;
+                if (((i == 0) && (j == 0)) || (!level.TileIsValid(column, row)) || (!m_walkable[column * m_size.y + row]))
+                {
+                    continue;
+                }
+
+                int index = column * m_size.y + row;
+                if ((nextIndex == -1) || (m_G[index] < m_G[nextIndex]))
+                {
+                    nextIndex = index;
+                }
+            }
+        }
+
+        // Costs always fall towards the goal, so this only fails if the search is broken.
+        if ((nextIndex == -1) || (m_G[nextIndex] >= m_G[currentIndex]))
+        {
+            path.clear();
+            return false;
+        }
+
+        path.push_back(level.GetActualTileLocation(nextIndex / m_size.y, nextIndex % m_size.y));
+        currentIndex = nextIndex;
+    }
+
+    return true;
+}
+
+// Makes the next search a full one.
+void PathfindingPlanner::Reset()
+{
+    m_level = nullptr;
+    m_goalIndex = -1;
+}
+
+// Throws away the previous search and starts a new one from the goal.
+void PathfindingPlanner::Initialize(const Level& level, int startIndex, int goalIndex)
+{
+    m_level = &level;
+    m_size = level.GetSize();
+    m_revision = level.GetLayoutRevision();
+    m_isRepair = false;
+    m_keyModifier = 0;
+    m_startIndex = startIndex;
+    m_goalIndex = goalIndex;
+
+    int nodeCount = m_size.x * m_size.y;
+    m_walkable.assign(nodeCount, false);
+    for (int i = 0; i < m_size.x; i++)
+    {
+        for (int j = 0; j < m_size.y; j++)
+        {
+            m_walkable[i * m_size.y + j] = level.IsFloor(i, j);
+        }
+    }
+
+    m_G.assign(nodeCount, PLANNER_INFINITE_COST);
+    m_rhs.assign(nodeCount, PLANNER_INFINITE_COST);
+    m_openList.Resize(nodeCount);
+
+    m_rhs[goalIndex] = 0;
+    m_openList.Push(goalIndex, CalculateKey(goalIndex));
+}
+
+// Calculates the priority of a node in the open list.
+long long PathfindingPlanner::CalculateKey(int node) const
+{
+    // Ties are broken by the lower cost, so a node that got more expensive is expanded before the nodes that relied on it.
+    int cost = std::min(m_G[node], m_rhs[node]);
+    return (cost + Heuristic(m_startIndex, node) + m_keyModifier) * PLANNER_KEY_SCALE + cost;
+}
+
+// Calculates the distance between two nodes.
+int PathfindingPlanner::Heuristic(int first, int second) const
+{
+    // Every step costs the same, including diagonal ones.
+    int dx = std::abs(first / m_size.y - second / m_size.y);
+    int dy = std::abs(first % m_size.y - second % m_size.y);
+    return PATHFINDING_STEP_COST * std::max(dx, dy);
+}
+
+// Recalculates the cost of a node from its neighbors.
+void PathfindingPlanner::UpdateNode(int node)
+{
+    m_touchedNodeCount++;
+
+    if (node != m_goalIndex)
+    {
+        int rhs = PLANNER_INFINITE_COST;
+        if (m_walkable[node])
+        {
+            int column = node / m_size.y;
+            int row = node % m_size.y;
+            for (int i = -1; i <= 1; i++)
+            {
+                for (int j = -1; j <= 1; j++)
+                {
+                    int adjacentColumn = column + i;
+                    int adjacentRow = row + j;
+                    if (((i == 0) && (j == 0)) || (adjacentColumn < 0) || (adjacentColumn >= m_size.x) || (adjacentRow < 0) || (adjacentRow >= m_size.y))
+                    {
+                        continue;
+                    }
+
+                    int adjacentIndex = adjacentColumn * m_size.y + adjacentRow;
+                    if (m_walkable[adjacentIndex])
+                    {
+                        rhs = std::min(rhs, m_G[adjacentIndex] + PATHFINDING_STEP_COST);
+                    }
+                }
+            }
+        }
+        m_rhs[node] = std::min(rhs, PLANNER_INFINITE_COST);
+    }
+
+    // Only nodes whose costs disagree need to be expanded.
+    bool isConsistent = (m_G[node] == m_rhs[node]);
+    if (m_openList.Contains(node))
+    {
+        if (isConsistent)
+        {
+            m_openList.Remove(node);
+        }
+        else
+        {
+            m_openList.UpdateKey(node, CalculateKey(node));
+        }
+    }
+    else if (!isConsistent)
+    {
+        m_openList.Push(node, CalculateKey(node));
+    }
+}
+
+// Expands nodes until the cost of the start is correct.
+void PathfindingPlanner::ComputeShortestPath()
+{
+    while ((!m_openList.IsEmpty()) && ((m_openList.GetTopKey() < CalculateKey(m_startIndex)) || (m_rhs[m_startIndex] != m_G[m_startIndex])))
+    {
+        int node = m_openList.GetTop();
+        long long oldKey = m_openList.GetTopKey();
+        long long newKey = CalculateKey(node);
+
+        // The key was made before the start last moved, so put the node back in its proper place.
+        if (oldKey < newKey)
+        {
+            m_openList.UpdateKey(node, newKey);
+            continue;
+        }
+
+        m_openList.Pop();
+        m_expandedNodeCount++;
+        int column = node / m_size.y;
+        int row = node % m_size.y;
+
+        if (m_G[node] > m_rhs[node])
+        {
+            // The node got cheaper. Its cost is now final, so pass it on to its neighbors.
+            m_G[node] = m_rhs[node];
+        }
+        else
+        {
+            // The node got more expensive. Forget its cost, and let it and its neighbors look for new ones.
+            m_G[node] = PLANNER_INFINITE_COST;
+            UpdateNode(node);
+        }
+
+        for (int i = -1; i <= 1; i++)
+        {
+            for (int j = -1; j <= 1; j++)
+            {
+                int adjacentColumn = column + i;
+                int adjacentRow = row + j;
+                if (((i == 0) && (j == 0)) || (adjacentColumn < 0) || (adjacentColumn >= m_size.x) || (adjacentRow < 0) || (adjacentRow >= m_size.y))
+                {
+                    continue;
+                }
+
+                UpdateNode(adjacentColumn * m_size.y + adjacentRow);
+            }
+        }
+    }
+}
+
+// Checks if the last search repaired the one before it.
+bool PathfindingPlanner::IsRepair() const
+{
+    return m_isRepair;
+}
+
+// Gets the number of nodes that the last search expanded.
+int PathfindingPlanner::GetExpandedNodeCount() const
+{
+    return m_expandedNodeCount;
+}
+
+// Gets the number of nodes that the last search touched.
+int PathfindingPlanner::GetTouchedNodeCount() const
+{
+    return m_touchedNodeCount;
+}
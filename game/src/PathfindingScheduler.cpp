@@ -0,0 +1,188 @@
+#include <algorithm>
+#include <chrono>
+#include "PCH.h"
+#include "PathfindingScheduler.h"
+
+// Default constructor.
+PathfindingScheduler::PathfindingScheduler() :
+m_nextOrder(0),
+m_expandedNodeCount(0)
+{
+}
+
+// Requests a new path for an enemy.
+void PathfindingScheduler::Request(Enemy* enemy, const Tile* startNode, const Tile* goalNode, float priority)
+{
+    Cancel(enemy);
+    m_searches.push_back({ enemy, startNode, goalNode, priority, m_nextOrder++, -1, 0 });
+}
+
+// Cancels the request for an enemy.
+void PathfindingScheduler::Cancel(const Enemy* enemy)
+{
+    for (auto it = m_searches.begin(); it != m_searches.end(); ++it)
+    {
+        if (it->enemy == enemy)
+        {
+            ReleaseContext(*it);
+            m_searches.erase(it);
+            return;
+        }
+    }
+}
+
+// Cancels all requests.
+void PathfindingScheduler::Clear()
+{
+    for (auto& search : m_searches)
+    {
+        ReleaseContext(search);
+    }
+    m_searches.clear();
+}
+
+// Runs requests, closest first, until the time budget has been used up.
+int PathfindingScheduler::Update(const Level& level, PATHFINDING_MODE mode, const PathfindingHierarchy* hierarchy, PathCache* cache, int budget, PathfindingBatch* batch)
+{
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(budget);
+    m_expandedNodeCount = 0;
+    int finishedCount = 0;
+
+    // Requests at the same distance run in the order they were made.
+    std::sort(m_searches.begin(), m_searches.end(), [](const PendingSearch& a, const PendingSearch& b)
+    {
+        return (a.priority < b.priority) || ((a.priority == b.priority) && (a.order < b.order));
+    });
+
+    // Run the closest requests a group at a time across the worker threads. The batch checks the cache, and searches repeated requests only once.
+    if (batch != nullptr)
+    {
+        while ((!m_searches.empty()) && (std::chrono::steady_clock::now() < deadline))
+        {
+            int groupSize = std::min(static_cast<int>(m_searches.size()), batch->GetThreadCount());
+            batch->Clear();
+            for (int i = 0; i < groupSize; ++i)
+            {
+                // A search paused by an update without a batch starts again in the batch.
+                ReleaseContext(m_searches[i]);
+                batch->Add(m_searches[i].startNode, m_searches[i].goalNode);
+            }
+            batch->Run(level, mode, hierarchy, cache);
+
+            for (int i = 0; i < groupSize; ++i)
+            {
+                m_expandedNodeCount += batch->GetExpandedNodeCount(i);
+                m_searches[i].enemy->SetPath(batch->GetPath(i), batch->GetExpandedNodeCount(i));
+            }
+            m_searches.erase(m_searches.begin(), m_searches.begin() + groupSize);
+            finishedCount += groupSize;
+        }
+
+        return finishedCount;
+    }
+
+    sf::Vector2i levelSize = level.GetSize();
+    size_t next = 0;
+
+    while ((next < m_searches.size()) && (std::chrono::steady_clock::now() < deadline))
+    {
+        PendingSearch& search = m_searches[next];
+        PATHFINDING_STATUS status = PATHFINDING_STATUS::IN_PROGRESS;
+
+        // A paused search is out of date if a tile has changed between floor and solid since it started.
+        if ((search.context != -1) && (search.revision != level.GetWalkabilityRevision()))
+        {
+            ReleaseContext(search);
+        }
+
+        if ((search.context == -1) && (cache != nullptr) && cache->Find(level, search.startNode, search.goalNode, m_path))
+        {
+            search.enemy->SetPath(m_path, 0);
+            m_searches.erase(m_searches.begin() + next);
+            finishedCount++;
+            continue;
+        }
+
+        if (search.context == -1)
+        {
+            if (m_freeContexts.empty())
+            {
+                m_freeContexts.push_back(static_cast<int>(m_contexts.size()));
+                m_contexts.emplace_back();
+            }
+            search.context = m_freeContexts.back();
+            m_freeContexts.pop_back();
+            search.revision = level.GetWalkabilityRevision();
+
+            if (mode == PATHFINDING_MODE::A_STAR)
+            {
+                m_contexts[search.context].BeginPath(level, search.startNode, search.goalNode, sf::IntRect(0, 0, levelSize.x, levelSize.y));
+            }
+        }
+
+        PathfindingContext& context = m_contexts[search.context];
+        int previousExpandedNodeCount = (mode == PATHFINDING_MODE::A_STAR) ? context.GetExpandedNodeCount() : 0;
+
+        if (mode == PATHFINDING_MODE::A_STAR)
+        {
+            status = context.ContinuePath(level, PATHFINDING_SLICE_SIZE, m_path);
+        }
+        else
+        {
+            bool found;
+            if (mode == PATHFINDING_MODE::JUMP_POINT_SEARCH)
+            {
+                found = context.FindJumpPointPath(level, search.startNode, search.goalNode, m_path);
+            }
+            else if ((mode == PATHFINDING_MODE::HIERARCHICAL) && (hierarchy != nullptr))
+            {
+                found = context.FindHierarchicalPath(level, *hierarchy, search.startNode, search.goalNode, m_path);
+            }
+            else
+            {
+                found = context.FindPath(level, search.startNode, search.goalNode, m_path);
+            }
+            status = found ? PATHFINDING_STATUS::FOUND : PATHFINDING_STATUS::NOT_FOUND;
+        }
+        m_expandedNodeCount += context.GetExpandedNodeCount() - previousExpandedNodeCount;
+
+        if (status == PATHFINDING_STATUS::IN_PROGRESS)
+        {
+            continue;
+        }
+
+        // Hand the new path to the enemy. It followed its old path until now.
+        if (cache != nullptr)
+        {
+            cache->Store(level, search.startNode, search.goalNode, m_path);
+        }
+        search.enemy->SetPath(m_path, context.GetExpandedNodeCount());
+        ReleaseContext(search);
+        m_searches.erase(m_searches.begin() + next);
+        finishedCount++;
+    }
+
+    return finishedCount;
+}
+
+// Releases the search context of a request.
+void PathfindingScheduler::ReleaseContext(PendingSearch& search)
+{
+    if (search.context != -1)
+    {
+        m_freeContexts.push_back(search.context);
+        search.context = -1;
+    }
+}
+
+// Gets the number of requests that haven't finished.
+int PathfindingScheduler::GetPendingCount() const
+{
+    return static_cast<int>(m_searches.size());
+}
+
+// Gets the number of nodes expanded in the last update.
+int PathfindingScheduler::GetExpandedNodeCount() const
+{
+    return m_expandedNodeCount;
+}
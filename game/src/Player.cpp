@@ -3,38 +3,39 @@
 #include "Player.h"
 
 // Constructor.
-Player::Player() :
+Player::Player(std::uint64_t seed) :
 m_attackDelta(0.f),
 m_damageDelta(0.f),
 m_manaDelta(0.f),
 m_isAttacking(false),
-m_canTakeDamage(true)
+m_canTakeDamage(true),
+m_random(Random::GetRoomSeed(seed, 0), RANDOM_STREAM::PLAYER)
 {
     // Generate a random class.
-    m_class = static_cast<PLAYER_CLASS>(std::rand() % static_cast<int>(PLAYER_CLASS::COUNT));
+    m_class = static_cast<PLAYER_CLASS>(m_random.Next(static_cast<int>(PLAYER_CLASS::COUNT)));
 
     std::string className;
     // Set class-specific variables.
     switch (m_class)
     {
         case PLAYER_CLASS::WARRIOR:
-            m_strength += std::rand() % 6 + 5;
+            m_strength += m_random.Next(6) + 5;
             className = "warrior";
             break;
         case PLAYER_CLASS::MAGE:
-            m_defense = std::rand() % 6 + 5;
+            m_defense = m_random.Next(6) + 5;
             className = "mage";
             break;
         case PLAYER_CLASS::ARCHER:
-            m_dexterity = std::rand() % 6 + 5;
+            m_dexterity = m_random.Next(6) + 5;
             className = "archer";
             break;
         case PLAYER_CLASS::THIEF:
-            m_stamina = std::rand() % 6 + 5;
+            m_stamina = m_random.Next(6) + 5;
             className = "thief";
             break;
         default:
-            m_strength += std::rand() % 6 + 5;
+            m_strength += m_random.Next(6) + 5;
             className = "warrior";
             break;
     }
@@ -67,11 +68,11 @@ m_canTakeDamage(true)
 
     // Generate players stats randomly.
     m_statPoints = 50;
-    float attackBias = std::rand() % 101;
-    float defenseBias = std::rand() % 101;
-    float strengthBias = std::rand() % 101;
-    float dexterityBias = std::rand() % 101;
-    float staminaBias = std::rand() % 101;
+    float attackBias = m_random.Next(101);
+    float defenseBias = m_random.Next(101);
+    float strengthBias = m_random.Next(101);
+    float dexterityBias = m_random.Next(101);
+    float staminaBias = m_random.Next(101);
 
     float total = attackBias + defenseBias + strengthBias + dexterityBias
                   + staminaBias;
@@ -317,7 +318,7 @@ void Player::SetRandomTraits()
         int index(0);
         while (true)
         {
-            index = std::rand() % static_cast<int>(PLAYER_TRAIT::COUNT);
+            index = m_random.Next(static_cast<int>(PLAYER_TRAIT::COUNT));
             if (std::find(traitIndex.begin(), traitIndex.end(), index) == traitIndex.end()) break;
         }
 
@@ -336,22 +337,22 @@ void Player::SetRandomTraits()
         switch (trait)
         {
             case PLAYER_TRAIT::ATTACK:
-                m_attack += std::rand() % 6 + 5;
+                m_attack += m_random.Next(6) + 5;
                 break;
             case PLAYER_TRAIT::DEFENSE:
-                m_defense += std::rand() % 6 + 5;
+                m_defense += m_random.Next(6) + 5;
                 break;
             case PLAYER_TRAIT::STRENGTH:
-                m_strength += std::rand() % 6 + 5;
+                m_strength += m_random.Next(6) + 5;
                 break;
             case PLAYER_TRAIT::DEXTERITY:
-                m_dexterity += std::rand() % 6 + 5;
+                m_dexterity += m_random.Next(6) + 5;
                 break;
             case PLAYER_TRAIT::STAMINA:
-                m_stamina += std::rand() % 6 + 5;
+                m_stamina += m_random.Next(6) + 5;
                 break;
             default:
-                m_defense += std::rand() % 6 + 5;
+                m_defense += m_random.Next(6) + 5;
                 break;
         }
     }
@@ -377,6 +378,6 @@ int Player::CalculateDamage()
 {
     float damage_scale(1.f);
     damage_scale += PLAYER_DEXTERITY_DAMAGE_SCALE * m_dexterity;
-    float damage = (std::rand() % (PLAYER_MAX_DAMAGE + 1)) + (PLAYER_ATTACK_DAMAGE_SCALE * m_attack);
+    float damage = (m_random.Next(PLAYER_MAX_DAMAGE + 1)) + (PLAYER_ATTACK_DAMAGE_SCALE * m_attack);
     return static_cast<int>(damage * damage_scale);
 }
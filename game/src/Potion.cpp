@@ -1,8 +1,8 @@
 #include "PCH.h"
 #include "Potion.h"
 
-// Default constructor.
-Potion::Potion() :
+// Constructor.
+Potion::Potion(Random& random) :
 m_attack(0),
 m_defense(0),
 m_strength(0),
@@ -13,33 +13,33 @@ m_stamina(0)
     std::string spriteFilePath;
 
     // Set the potion type.
-    m_potionType = static_cast<POTION>(std::rand() % static_cast<int>(POTION::COUNT));
+    m_potionType = static_cast<POTION>(random.Next(static_cast<int>(POTION::COUNT)));
 
     // Set stat modifiers, sprite file path, and item name.
     switch (m_potionType)
     {
         case POTION::ATTACK:
-            m_dexterity = std::rand() % 5 + 5;
+            m_dexterity = random.Next(5) + 5;
             spriteFilePath = "../resources/loot/potions/spr_potion_attack.png";
             break;
         case POTION::DEFENSE:
-            m_dexterity = std::rand() % 5 + 5;
+            m_dexterity = random.Next(5) + 5;
             spriteFilePath = "../resources/loot/potions/spr_potion_defense.png";
             break;
         case POTION::STRENGTH:
-            m_strength = std::rand() % 5 + 5;
+            m_strength = random.Next(5) + 5;
             spriteFilePath = "../resources/loot/potions/spr_potion_strength.png";
             break;
         case POTION::DEXTERITY:
-            m_dexterity = std::rand() % 5 + 5;
+            m_dexterity = random.Next(5) + 5;
             spriteFilePath = "../resources/loot/potions/spr_potion_dexterity.png";
             break;
         case POTION::STAMINA:
-            m_stamina = std::rand() % 5 + 5;
+            m_stamina = random.Next(5) + 5;
             spriteFilePath = "../resources/loot/potions/spr_potion_stamina.png";
             break;
         default:
-            m_dexterity = std::rand() % 11 + 5;
+            m_dexterity = random.Next(11) + 5;
             spriteFilePath = "../resources/loot/potions/spr_potion_attack.png";
             break;
     }
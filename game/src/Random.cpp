@@ -0,0 +1,61 @@
+#include "PCH.h"
+#include "Random.h"
+
+// The multiplier of the generator's linear congruential step.
+static std::uint64_t const RANDOM_MULTIPLIER = 6364136223846793005ULL;
+
+// Default constructor.
+Random::Random() :
+m_state(0),
+m_increment(1)
+{
+    Seed(0, RANDOM_STREAM::LEVEL);
+}
+
+// Creates a generator for one stream of a seed.
+Random::Random(std::uint64_t seed, RANDOM_STREAM stream) :
+m_state(0),
+m_increment(1)
+{
+    Seed(seed, stream);
+}
+
+// Restarts the generator from a seed.
+void Random::Seed(std::uint64_t seed, RANDOM_STREAM stream)
+{
+    // This is PCG32, which gives each odd increment its own sequence.
+    m_state = 0;
+    m_increment = (static_cast<std::uint64_t>(stream) << 1) | 1;
+    Next();
+    m_state += seed;
+    Next();
+}
+
+// Gets the next random number.
+std::uint32_t Random::Next()
+{
+    std::uint64_t state = m_state;
+    m_state = state * RANDOM_MULTIPLIER + m_increment;
+
+    // Scramble the old state, rotating by its top bits.
+    std::uint32_t bits = static_cast<std::uint32_t>(((state >> 18) ^ state) >> 27);
+    std::uint32_t rotation = static_cast<std::uint32_t>(state >> 59);
+    return (bits >> rotation) | (bits << ((32 - rotation) & 31));
+}
+
+// Gets a random number between 0 and count - 1.
+int Random::Next(int count)
+{
+    // Scale into the range with a multiply rather than a divide.
+    return static_cast<int>((static_cast<std::uint64_t>(Next()) * static_cast<std::uint32_t>(count)) >> 32);
+}
+
+// Gets the seed of one room of a run.
+std::uint64_t Random::GetRoomSeed(std::uint64_t seed, int roomIndex)
+{
+    // Mix the room into the seed with SplitMix64, so neighbouring rooms get unrelated seeds.
+    std::uint64_t roomSeed = seed + (static_cast<std::uint64_t>(roomIndex) + 1) * 0x9E3779B97F4A7C15ULL;
+    roomSeed = (roomSeed ^ (roomSeed >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    roomSeed = (roomSeed ^ (roomSeed >> 27)) * 0x94D049BB133111EBULL;
+    return roomSeed ^ (roomSeed >> 31);
+}
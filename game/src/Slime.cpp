@@ -1,8 +1,9 @@
 #include "PCH.h"
 #include "Slime.h"
 
-// Default constructor.
-Slime::Slime()
+// Constructor.
+Slime::Slime(Random& random) :
+Enemy(random)
 {
     // Load textures.
     m_textureIDs[static_cast<int>(ANIMATION_STATE::WALK_UP)] = TextureManager::AddTexture("../resources/enemies/slime/spr_slime_walk_up.png");
@@ -19,10 +20,10 @@ Slime::Slime()
 
     // Set a random color for the slime sprite.
     sf::Uint8 r, g, b, a;
-    r = static_cast<sf::Uint8>(std::rand() % 256);
-    g = static_cast<sf::Uint8>(std::rand() % 256);
-    b = static_cast<sf::Uint8>(std::rand() % 256);
-    a = static_cast<sf::Uint8>((std::rand() % 156) + 100);
+    r = static_cast<sf::Uint8>(random.Next(256));
+    g = static_cast<sf::Uint8>(random.Next(256));
+    b = static_cast<sf::Uint8>(random.Next(256));
+    a = static_cast<sf::Uint8>((random.Next(156)) + 100);
 
     sf::Color color(r, g, b, a);
     m_sprite.setColor(color);
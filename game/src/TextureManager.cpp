@@ -57,5 +57,8 @@ sf::Texture& TextureManager::GetTexture(int textureID)
         }
     }
 
-    // TODO: Return dummy object if not found required texture
+    // The texture was not found. Return an empty texture so that headless callers,
+    // such as levels created without a window, can still set sprite textures.
+    static sf::Texture emptyTexture;
+    return emptyTexture;
 }
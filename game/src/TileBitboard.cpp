@@ -0,0 +1,184 @@
+#include "PCH.h"
+#include "TileBitboard.h"
+
+// Default constructor.
+TileBitboard::TileBitboard() :
+m_size({ 0, 0 }),
+m_wordsPerColumn(0)
+{
+}
+
+// Creates a bitboard for a grid of tiles.
+TileBitboard::TileBitboard(sf::Vector2i size) :
+m_size({ 0, 0 }),
+m_wordsPerColumn(0)
+{
+    Reset(size);
+}
+
+// Resizes the bitboard and clears every bit.
+void TileBitboard::Reset(sf::Vector2i size)
+{
+    m_size = size;
+    m_wordsPerColumn = (size.y + 63) / 64;
+    m_words.assign(size.x * m_wordsPerColumn, 0);
+}
+
+// Gets the size of the grid the bitboard covers.
+sf::Vector2i TileBitboard::GetSize() const
+{
+    return m_size;
+}
+
+// Checks the bit of a tile.
+bool TileBitboard::Test(int columnIndex, int rowIndex) const
+{
+    if ((columnIndex < 0) || (columnIndex >= m_size.x) || (rowIndex < 0) || (rowIndex >= m_size.y))
+    {
+        return false;
+    }
+
+    return ((m_words[columnIndex * m_wordsPerColumn + (rowIndex >> 6)] >> (rowIndex & 63)) & 1) != 0;
+}
+
+// Sets or clears the bit of a tile.
+void TileBitboard::Set(int columnIndex, int rowIndex, bool value)
+{
+    std::uint64_t& word = m_words[columnIndex * m_wordsPerColumn + (rowIndex >> 6)];
+    std::uint64_t bit = 1ULL << (rowIndex & 63);
+    word = value ? (word | bit) : (word & ~bit);
+}
+
+// Counts the tiles whose bits are set.
+int TileBitboard::Count() const
+{
+    int count = 0;
+    for (std::uint64_t word : m_words)
+    {
+        count += CountBits(word);
+    }
+    return count;
+}
+
+// Gets a bitboard where each tile holds the bit of the tile at an offset from it.
+TileBitboard TileBitboard::Shifted(int columnOffset, int rowOffset) const
+{
+    TileBitboard shifted(m_size);
+    if (m_wordsPerColumn == 0)
+    {
+        return shifted;
+    }
+
+    // Only the rows past the end of the last word of each column need clearing after a shift towards them.
+    std::uint64_t lastWordMask = ((m_size.y & 63) == 0) ? ~0ULL : ((1ULL << (m_size.y & 63)) - 1);
+
+    for (int i = 0; i < m_size.x; ++i)
+    {
+        int sourceColumn = i + columnOffset;
+        if ((sourceColumn < 0) || (sourceColumn >= m_size.x))
+        {
+            continue;
+        }
+
+        const std::uint64_t* source = &m_words[sourceColumn * m_wordsPerColumn];
+        std::uint64_t* target = &shifted.m_words[i * m_wordsPerColumn];
+        for (int word = 0; word < m_wordsPerColumn; ++word)
+        {
+            if (rowOffset > 0)
+            {
+                // Each row reads a later row, so bits move down and the next word's low bits carry in at the top.
+                target[word] = source[word] >> rowOffset;
+                if (word + 1 < m_wordsPerColumn)
+                {
+                    target[word] |= source[word + 1] << (64 - rowOffset);
+                }
+            }
+            else if (rowOffset < 0)
+            {
+                // Each row reads an earlier row, so bits move up and the previous word's high bits carry in at the bottom.
+                target[word] = source[word] << -rowOffset;
+                if (word > 0)
+                {
+                    target[word] |= source[word - 1] >> (64 + rowOffset);
+                }
+            }
+            else
+            {
+                target[word] = source[word];
+            }
+        }
+        target[m_wordsPerColumn - 1] &= lastWordMask;
+    }
+
+    return shifted;
+}
+
+// Gets the bits of the eight tiles around a tile in one mask.
+int TileBitboard::GetNeighborMask(int columnIndex, int rowIndex) const
+{
+    std::uint64_t mask = GetColumnBits(columnIndex - 1, rowIndex - 1, 3);
+    mask |= GetColumnBits(columnIndex, rowIndex - 1, 3) << 3;
+    mask |= GetColumnBits(columnIndex + 1, rowIndex - 1, 3) << 6;
+    return static_cast<int>(mask & ~(1ULL << 4));
+}
+
+// Gets which of the four tiles beside a tile are set.
+int TileBitboard::GetSideMask(int columnIndex, int rowIndex) const
+{
+    return (Test(columnIndex, rowIndex - 1) ? 1 : 0) + (Test(columnIndex + 1, rowIndex) ? 2 : 0) + (Test(columnIndex, rowIndex + 1) ? 4 : 0) + (Test(columnIndex - 1, rowIndex) ? 8 : 0);
+}
+
+// Keeps only the bits that are also set in another bitboard.
+TileBitboard& TileBitboard::operator&=(const TileBitboard& other)
+{
+    for (size_t i = 0; i < m_words.size(); ++i)
+    {
+        m_words[i] &= other.m_words[i];
+    }
+    return *this;
+}
+
+// Sets every bit that is set in another bitboard.
+TileBitboard& TileBitboard::operator|=(const TileBitboard& other)
+{
+    for (size_t i = 0; i < m_words.size(); ++i)
+    {
+        m_words[i] |= other.m_words[i];
+    }
+    return *this;
+}
+
+// Gets the bits of a run of tiles in a column.
+std::uint64_t TileBitboard::GetColumnBits(int columnIndex, int rowIndex, int count) const
+{
+    if ((columnIndex < 0) || (columnIndex >= m_size.x))
+    {
+        return 0;
+    }
+
+    // Rows above the grid read as clear.
+    int skipped = 0;
+    if (rowIndex < 0)
+    {
+        skipped = -rowIndex;
+        count -= skipped;
+        rowIndex = 0;
+    }
+
+    int word = rowIndex >> 6;
+    int bit = rowIndex & 63;
+    if ((count <= 0) || (word >= m_wordsPerColumn))
+    {
+        return 0;
+    }
+
+    // The run can straddle two words. Rows below the grid are already clear.
+    const std::uint64_t* column = &m_words[columnIndex * m_wordsPerColumn];
+    std::uint64_t bits = column[word] >> bit;
+    if ((bit + count > 64) && (word + 1 < m_wordsPerColumn))
+    {
+        bits |= column[word + 1] << (64 - bit);
+    }
+
+    return (bits & ((1ULL << count) - 1)) << skipped;
+}
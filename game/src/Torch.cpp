@@ -1,9 +1,10 @@
 #include "PCH.h"
 #include "Torch.h"
 
-// Default constructor.
-Torch::Torch() :
-m_brightness(1.f)
+// Constructor.
+Torch::Torch(std::uint64_t seed) :
+m_brightness(1.f),
+m_random(seed, RANDOM_STREAM::EFFECTS)
 {
     // Set sprite.
     int textureID = TextureManager::AddTexture("../resources/spr_torch.png");
@@ -14,7 +15,7 @@ m_brightness(1.f)
 void Torch::Update(float timeDelta)
 {
     // Generate a random number between 80 and 120, divide by 100 and store as float between .8 and 1.2.
-    m_brightness = (std::rand() % 41 + 80) / 100.f;
+    m_brightness = (m_random.Next(41) + 80) / 100.f;
 }
 
 // Returns the brightness of the torch.
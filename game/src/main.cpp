@@ -21,13 +21,12 @@ unsigned int mix(unsigned long a, unsigned long b, unsigned long c)
 // Entry point of the application.
 int main()
 {
-    // Set a random seed.
+    // Choose the seed of the first run. Everything random in the game is derived from it.
     unsigned int seed = mix(clock(), static_cast<unsigned long>(time(NULL)), 1024);
-    srand(seed);
 
     // Create the main game object.
     sf::RenderWindow window(sf::VideoMode::getDesktopMode(), "Dungeon prowler", sf::Style::Fullscreen);
-    Game game(&window);
+    Game game(&window, seed);
 
     // Initialize and run the game object.
     game.Initialize();
@@ -0,0 +1,180 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include "PCH.h"
+#include "LevelGenerator.h"
+
+// The number of levels to generate, one per seed.
+static int const BATCH_DEFAULT_SEED_COUNT = 1000;
+
+// The files the levels and their stats are written to.
+static char const* const BATCH_DEFAULT_PACK_FILE = "levels.pack";
+static char const* const BATCH_DEFAULT_CSV_FILE = "levels.csv";
+
+
+// The stats of one generated level.
+struct LevelStats
+{
+    long long generationTime;       // The time GenerateLayout() took in microseconds.
+    long long populateTime;         // The time choosing the items and enemies took in microseconds.
+    int tileCount;
+    int floorCount;
+    int reachableCount;
+    int torchCount;
+    int deadEndCount;
+    int itemCount;
+    int enemyCount;
+};
+
+
+// Generates and measures the level for one seed, without a window or any textures.
+static void GenerateLevel(std::uint64_t seed, sf::Vector2i levelSize, std::vector<unsigned char>& data, LevelStats& stats)
+{
+    Level level(levelSize);
+    level.SetSeed(seed);
+
+    // GenerateLevel() would also bind the sprites and create the torches, which share the texture manager and so can't run on several threads.
+    // The layout is everything the game keeps, so only that is generated.
+    auto generationStart = std::chrono::steady_clock::now();
+    level.GenerateLayout();
+    auto populateStart = std::chrono::steady_clock::now();
+    SpawnPlan spawnPlan;
+    LevelGenerator::PlanSpawns(level, spawnPlan);
+    auto populateEnd = std::chrono::steady_clock::now();
+
+    stats.generationTime = std::chrono::duration_cast<std::chrono::microseconds>(populateStart - generationStart).count();
+    stats.populateTime = std::chrono::duration_cast<std::chrono::microseconds>(populateEnd - populateStart).count();
+    stats.tileCount = level.GetSize().x * level.GetSize().y;
+    stats.floorCount = level.GetWalkableTiles().Count();
+    stats.reachableCount = static_cast<int>(level.GetReachableTiles().size());
+    stats.torchCount = static_cast<int>(level.GetTorchLocations().size());
+    stats.itemCount = static_cast<int>(spawnPlan.items.size());
+    stats.enemyCount = static_cast<int>(spawnPlan.enemies.size());
+
+    // A dead end is a floor tile with floor on only one side.
+    stats.deadEndCount = 0;
+    level.GetWalkableTiles().ForEachWithSides([&](int, int, int sides)
+    {
+        if (CountBits(static_cast<std::uint64_t>(sides)) == 1)
+        {
+            stats.deadEndCount++;
+        }
+    });
+
+    level.Serialize(data);
+}
+
+// Generates a level for each of a range of seeds across every core, and writes them to a level pack along with a CSV of their stats.
+// Usage: batch_generator [--seeds N] [--first-seed N] [--size N] [--threads N] [--pack PATH] [--csv PATH]
+// The level for seed first-seed + N has ID N in the pack. A thread count of 0 uses every core.
+int main(int argc, char* argv[])
+{
+    int seedCount = BATCH_DEFAULT_SEED_COUNT;
+    std::uint64_t firstSeed = 0;
+    sf::Vector2i levelSize(GRID_WIDTH, GRID_HEIGHT);
+    int threadCount = 0;
+    std::string packFile = BATCH_DEFAULT_PACK_FILE;
+    std::string csvFile = BATCH_DEFAULT_CSV_FILE;
+
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        std::string option = argv[i];
+        if (option == "--seeds")
+        {
+            seedCount = std::max(0, std::atoi(argv[i + 1]));
+        }
+        else if (option == "--first-seed")
+        {
+            firstSeed = std::strtoull(argv[i + 1], nullptr, 10);
+        }
+        else if (option == "--size")
+        {
+            levelSize.x = levelSize.y = std::atoi(argv[i + 1]);
+        }
+        else if (option == "--threads")
+        {
+            threadCount = std::max(0, std::atoi(argv[i + 1]));
+        }
+        else if (option == "--pack")
+        {
+            packFile = argv[i + 1];
+        }
+        else if (option == "--csv")
+        {
+            csvFile = argv[i + 1];
+        }
+        else
+        {
+            std::cerr << "unknown option: " << option << std::endl;
+            return 1;
+        }
+    }
+
+    if (threadCount == 0)
+    {
+        threadCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+
+    // Each seed writes only its own slot, so the output is the same however the seeds are shared out.
+    std::vector<std::vector<unsigned char>> levels(seedCount);
+    std::vector<LevelStats> stats(seedCount);
+    std::atomic<int> nextSeed(0);
+
+    auto work = [&]
+    {
+        for (int i = nextSeed++; i < seedCount; i = nextSeed++)
+        {
+            GenerateLevel(firstSeed + i, levelSize, levels[i], stats[i]);
+        }
+    };
+
+    auto batchStart = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int i = 1; i < threadCount; ++i)
+    {
+        threads.emplace_back(work);
+    }
+    work();
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - batchStart).count();
+
+    if (!LevelPack::Write(packFile, levels))
+    {
+        std::cerr << "could not write " << packFile << std::endl;
+        return 1;
+    }
+
+    std::ofstream csv(csvFile);
+    if (!csv.is_open())
+    {
+        std::cerr << "could not write " << csvFile << std::endl;
+        return 1;
+    }
+
+    csv << "level_id,seed,generation_us,populate_us,floor_ratio,reachable_ratio,torches,dead_ends,items,enemies" << std::endl;
+    long long totalGenerationTime = 0;
+    for (int i = 0; i < seedCount; ++i)
+    {
+        const LevelStats& level = stats[i];
+        csv << i << "," << (firstSeed + i) << "," << level.generationTime << "," << level.populateTime << ","
+            << static_cast<double>(level.floorCount) / level.tileCount << ","
+            << ((level.floorCount > 0) ? static_cast<double>(level.reachableCount) / level.floorCount : 0.0) << ","
+            << level.torchCount << "," << level.deadEndCount << "," << level.itemCount << "," << level.enemyCount << std::endl;
+        totalGenerationTime += level.generationTime + level.populateTime;
+    }
+
+    std::cout << "levels:                 " << seedCount << std::endl;
+    std::cout << "threads:                " << threadCount << std::endl;
+    std::cout << "batch time (s):         " << seconds << std::endl;
+    std::cout << "levels per second:      " << ((seconds > 0.0) ? seedCount / seconds : 0.0) << std::endl;
+    std::cout << "mean generation (us):   " << ((seedCount > 0) ? static_cast<double>(totalGenerationTime) / seedCount : 0.0) << std::endl;
+    std::cout << "pack:                   " << packFile << std::endl;
+    std::cout << "stats:                  " << csvFile << std::endl;
+    return 0;
+}
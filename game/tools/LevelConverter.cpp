@@ -0,0 +1,31 @@
+#include <iostream>
+#include "PCH.h"
+#include "LevelFile.h"
+
+// Converts a level from the old bracketed text format to the binary level format, and checks that the result loads.
+// Usage: level_converter <text level> <binary level>
+int main(int argc, char** argv)
+{
+    if (argc != 3)
+    {
+        std::cerr << "usage: level_converter <text level> <binary level>" << std::endl;
+        return 1;
+    }
+
+    if (!LevelFile::ConvertTextLevel(argv[1], argv[2]))
+    {
+        std::cerr << "could not convert " << argv[1] << " to " << argv[2] << std::endl;
+        return 1;
+    }
+
+    LevelFile file;
+    if (!file.Open(argv[2]))
+    {
+        std::cerr << "the converted level " << argv[2] << " does not load" << std::endl;
+        return 1;
+    }
+
+    std::cout << argv[2] << ": " << file.GetSize().x << "x" << file.GetSize().y << " tiles, " << file.GetTorchCount() << " torches, "
+        << file.GetSpawnCount() << " spawns" << std::endl;
+    return 0;
+}
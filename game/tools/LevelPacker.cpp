@@ -0,0 +1,54 @@
+#include <iostream>
+#include "PCH.h"
+#include "LevelPack.h"
+
+// Bundles binary level files into a level pack, and checks that every level can be fetched from it.
+// Usage: level_packer <level pack> <binary level> [<binary level> ...]
+// The levels are given IDs in the order they are listed.
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        std::cerr << "usage: level_packer <level pack> <binary level> [<binary level> ...]" << std::endl;
+        return 1;
+    }
+
+    // Each level is checked before it is packed, so a bad file can't hide in the pack until it is fetched.
+    std::vector<std::vector<unsigned char>> levels;
+    for (int i = 2; i < argc; ++i)
+    {
+        MappedFile file;
+        LevelFile level;
+        if ((!file.Open(argv[i])) || (!level.Read(file.GetData(), file.GetSize())))
+        {
+            std::cerr << argv[i] << " is not a valid binary level" << std::endl;
+            return 1;
+        }
+        levels.emplace_back(file.GetData(), file.GetData() + file.GetSize());
+    }
+
+    if (!LevelPack::Write(argv[1], levels))
+    {
+        std::cerr << "could not write " << argv[1] << std::endl;
+        return 1;
+    }
+
+    LevelPack pack;
+    if ((!pack.Open(argv[1])) || (pack.GetLevelCount() != static_cast<int>(levels.size())))
+    {
+        std::cerr << "the level pack " << argv[1] << " does not load" << std::endl;
+        return 1;
+    }
+    for (int i = 0; i < pack.GetLevelCount(); ++i)
+    {
+        LevelFile level;
+        if (!pack.GetLevel(i, level))
+        {
+            std::cerr << "level " << i << " of " << argv[1] << " does not load" << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << argv[1] << ": " << pack.GetLevelCount() << " levels" << std::endl;
+    return 0;
+}